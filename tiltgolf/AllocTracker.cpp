@@ -0,0 +1,138 @@
+#include "AllocTracker.h"
+
+#ifdef TILTGOLF_TRACK_ALLOCS
+
+#include <execinfo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+// Fixed tables only: nothing here may allocate while counting.
+static const int MAX_SITES = 32;
+static const int SITE_DEPTH = 8;
+
+struct AllocSite {
+    void *frames[SITE_DEPTH];
+    int depth;
+    uint64_t count;
+    uint64_t bytes;
+};
+
+static thread_local bool armed = false;
+static thread_local bool inHook = false;
+static thread_local uint64_t allocCount = 0;
+static thread_local uint64_t allocBytes = 0;
+static AllocSite sites[MAX_SITES];
+static int siteCount = 0;
+static uint64_t droppedSites = 0;
+
+bool AllocTracker::enabled() { return true; }
+
+void AllocTracker::begin() {
+    // backtrace() loads libgcc (and allocates) on first use; do that before arming
+    void *warm[2];
+    backtrace(warm, 2);
+
+    allocCount = allocBytes = 0;
+    siteCount = 0;
+    droppedSites = 0;
+    armed = true;
+}
+
+void AllocTracker::end() { armed = false; }
+
+uint64_t AllocTracker::count() { return allocCount; }
+uint64_t AllocTracker::bytes() { return allocBytes; }
+
+void AllocTracker::record(size_t size) {
+    if (!armed || inHook)
+        return;
+    inHook = true;
+
+    allocCount++;
+    allocBytes += size;
+
+    // Skip record() and the allocation function itself
+    void *frames[SITE_DEPTH + 2];
+    int depth = backtrace(frames, SITE_DEPTH + 2) - 2;
+    if (depth < 0)
+        depth = 0;
+
+    AllocSite *site = nullptr;
+    for (int i = 0; i < siteCount && !site; ++i) {
+        if (sites[i].depth == depth && memcmp(sites[i].frames, frames + 2, depth * sizeof(void *)) == 0)
+            site = &sites[i];
+    }
+    if (!site && siteCount < MAX_SITES) {
+        site = &sites[siteCount++];
+        memcpy(site->frames, frames + 2, depth * sizeof(void *));
+        site->depth = depth;
+        site->count = site->bytes = 0;
+    }
+    if (site) {
+        site->count++;
+        site->bytes += size;
+    } else {
+        droppedSites++;
+    }
+
+    inHook = false;
+}
+
+void AllocTracker::report() {
+    fprintf(stderr, "AllocTracker: %llu allocations, %llu bytes from %d call sites\n",
+            (unsigned long long)allocCount, (unsigned long long)allocBytes, siteCount);
+    for (int i = 0; i < siteCount; ++i) {
+        fprintf(stderr, "-- site %d: %llu allocations, %llu bytes\n", i,
+                (unsigned long long)sites[i].count, (unsigned long long)sites[i].bytes);
+        fflush(stderr);
+        backtrace_symbols_fd(sites[i].frames, sites[i].depth, 2);
+    }
+    if (droppedSites)
+        fprintf(stderr, "-- %llu allocations from sites past the table limit\n", (unsigned long long)droppedSites);
+}
+
+// Global operator new/delete routed through the counter
+void *operator new(size_t size) {
+    AllocTracker::record(size);
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) {
+    AllocTracker::record(size);
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    AllocTracker::record(size);
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    AllocTracker::record(size);
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+#else
+
+bool AllocTracker::enabled() { return false; }
+void AllocTracker::begin() {}
+void AllocTracker::end() {}
+uint64_t AllocTracker::count() { return 0; }
+uint64_t AllocTracker::bytes() { return 0; }
+void AllocTracker::report() {}
+void AllocTracker::record(size_t) {}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Counts heap allocations made by the current thread between begin() and end().
+// Only active in the allocation-tracking build (CONFIG += track_allocs), which
+// replaces global operator new and routes b2Alloc through record() via
+// b2_user_settings.h. In normal builds every call is a no-op and
+// enabled() returns false.
+class AllocTracker {
+public:
+    static bool enabled();
+
+    // Start/stop counting on this thread (clears previous counts)
+    static void begin();
+    static void end();
+
+    static uint64_t count();
+    static uint64_t bytes();
+
+    // Print the distinct call sites that allocated (with backtraces) to stderr
+    static void report();
+
+    // Hook called by the tracked allocation paths
+    static void record(size_t size);
+};
+
+#endif
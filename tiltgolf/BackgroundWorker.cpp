@@ -0,0 +1,75 @@
+#include "BackgroundWorker.h"
+
+#include <cstring>
+#include <iostream>
+
+#include <sched.h>
+
+BackgroundWorker::BackgroundWorker() : busy(false), stopping(false), started(false) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, STACK_BYTES);
+    int err = pthread_create(&thread, &attr, &BackgroundWorker::entry, this);
+    pthread_attr_destroy(&attr);
+    started = err == 0;
+    if (!started)
+        std::cerr << "BackgroundWorker: cannot start thread: " << std::strerror(err) << ", jobs run inline" << std::endl;
+}
+
+BackgroundWorker::~BackgroundWorker() {
+    if (!started)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    pthread_join(thread, nullptr);
+}
+
+void BackgroundWorker::post(const std::function<void()> &job) {
+    if (!started) {
+        job();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    wake.notify_one();
+}
+
+void BackgroundWorker::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return jobs.empty() && !busy; });
+}
+
+void *BackgroundWorker::entry(void *self) {
+    static_cast<BackgroundWorker *>(self)->run();
+    return nullptr;
+}
+
+void BackgroundWorker::run() {
+    // Below every normal thread; lowering the policy needs no privileges
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    int err = pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+    if (err != 0)
+        std::cerr << "BackgroundWorker: SCHED_IDLE failed: " << std::strerror(err) << std::endl;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this]() { return !jobs.empty() || stopping; });
+        if (jobs.empty())
+            break;
+        std::function<void()> job = jobs.front();
+        jobs.pop_front();
+        busy = true;
+        lock.unlock();
+        job();
+        lock.lock();
+        busy = false;
+        if (jobs.empty())
+            idle.notify_all();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef BACKGROUNDWORKER_H
+#define BACKGROUNDWORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include <pthread.h>
+
+// One long-lived thread that runs posted jobs in order, for work the game
+// loop must never wait on (level templates, flow fields).
+//
+// The thread is started by the constructor with a small fixed stack and
+// drops itself to SCHED_IDLE, so it only gets the CPU when the game loop
+// does not want it, whatever policy it inherited. Create workers before
+// RealtimeProfile::apply(): posting a job then costs a queue push, not a
+// thread start (whose stack mlockall(MCL_FUTURE) would fault in and lock).
+class BackgroundWorker {
+public:
+    // Enough for building a Box2D world or a flow field; their data is on the heap
+    static const size_t STACK_BYTES = 256 * 1024;
+
+    BackgroundWorker();
+    // Runs the jobs still queued, then stops the thread
+    ~BackgroundWorker();
+
+    void post(const std::function<void()> &job);
+    // Block until every job posted so far has run
+    void wait();
+
+private:
+    BackgroundWorker(const BackgroundWorker &);
+    BackgroundWorker &operator=(const BackgroundWorker &);
+
+    static void *entry(void *self);
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wake;   // a job was posted or the worker is stopping
+    std::condition_variable idle;   // the queue ran empty
+    std::deque<std::function<void()> > jobs;
+    bool busy;
+    bool stopping;
+    bool started;
+    pthread_t thread;
+};
+
+#endif
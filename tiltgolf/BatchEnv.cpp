@@ -0,0 +1,144 @@
+#include "BatchEnv.h"
+#include "PhysicsEngine.h"
+
+#include <algorithm>
+
+// Blocks per thread and job: small enough to balance uneven environments,
+// large enough that claiming one is rare
+static const int BLOCKS_PER_THREAD = 8;
+
+BatchEnv::BatchEnv(int count, int threads)
+    : pendingInputs(nullptr), pendingLevel(nullptr), job(nullptr), generation(0), running(0), stopping(false),
+      nextEnv(0) {
+    count = std::max(0, count);
+    engines.reserve(count);
+    for (int i = 0; i < count; ++i)
+        engines.push_back(new PhysicsEngine(false));
+    position.assign(2 * count, 0.0f);
+    velocity.assign(2 * count, 0.0f);
+    holed.assign(count, 0);
+    respawnCount.assign(count, 0);
+    respawnBase.assign(count, 0);
+
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, std::max(1, count)));
+    blockSize = std::max(1, count / (threads * BLOCKS_PER_THREAD));
+    for (int i = 1; i < threads; ++i)
+        workers.push_back(std::thread(&BatchEnv::workerLoop, this));
+}
+
+BatchEnv::~BatchEnv() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : workers)
+        t.join();
+    for (PhysicsEngine *engine : engines)
+        delete engine;
+}
+
+void BatchEnv::loadLevel(const LevelView &level) {
+    pendingLevel = &level;
+    forEach(&BatchEnv::loadOne);
+    pendingLevel = nullptr;
+}
+
+void BatchEnv::setTickRate(int ticksPerSecond) {
+    for (PhysicsEngine *engine : engines)
+        engine->setTickRate(ticksPerSecond);
+}
+
+void BatchEnv::setAdaptiveStepping(bool enabled) {
+    for (PhysicsEngine *engine : engines)
+        engine->setAdaptiveStepping(enabled);
+}
+
+void BatchEnv::reset() {
+    forEach(&BatchEnv::resetOne);
+}
+
+void BatchEnv::reset(int env) {
+    resetOne(env);
+}
+
+void BatchEnv::step(const int16_t *inputs) {
+    pendingInputs = inputs;
+    forEach(&BatchEnv::stepOne);
+    pendingInputs = nullptr;
+}
+
+void BatchEnv::forEach(Job next) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = next;
+        nextEnv.store(0);
+        running = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+    work();
+
+    // The next job may only reset nextEnv once every worker is out of this one
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return running == 0; });
+}
+
+void BatchEnv::work() {
+    int count = size();
+    for (;;) {
+        int begin = nextEnv.fetch_add(blockSize);
+        if (begin >= count)
+            break;
+        int end = std::min(count, begin + blockSize);
+        for (int env = begin; env < end; ++env)
+            (this->*job)(env);
+    }
+}
+
+void BatchEnv::workerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        work();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0)
+            finished.notify_one();
+    }
+}
+
+void BatchEnv::loadOne(int env) {
+    engines[env]->loadLevel(*pendingLevel);
+    respawnBase[env] = engines[env]->getRespawnCount();
+    publish(env);
+}
+
+void BatchEnv::resetOne(int env) {
+    engines[env]->reset();
+    publish(env);
+}
+
+void BatchEnv::stepOne(int env) {
+    engines[env]->stepWithInput(pendingInputs[2 * env], pendingInputs[2 * env + 1]);
+    publish(env);
+}
+
+void BatchEnv::publish(int env) {
+    const PhysicsEngine &engine = *engines[env];
+    b2Vec2 p = engine.getBallPosition();
+    b2Vec2 v = engine.getBallVelocity();
+    position[2 * env] = p.x;
+    position[2 * env + 1] = p.y;
+    velocity[2 * env] = v.x;
+    velocity[2 * env + 1] = v.y;
+    holed[env] = engine.isBallInHole();
+    respawnCount[env] = engine.getRespawnCount() - respawnBase[env];
+}
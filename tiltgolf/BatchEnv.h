@@ -0,0 +1,97 @@
+#ifndef BATCHENV_H
+#define BATCHENV_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LevelData.h"
+
+class PhysicsEngine;
+
+// N independent ball-in-level simulations stepped together, for bots, tuning
+// sweeps and rollouts that need many games of one level at once.
+//
+// Each environment is its own PhysicsEngine without an IMU, so it steps
+// exactly like the game given the same calibrated tilt. step() takes one tilt
+// per environment and runs them on a pool of threads that lives as long as
+// the batch; environments are claimed in small blocks so slow ones (moving
+// water, busy contacts) do not hold up a whole thread. After every call the
+// state of all environments is in packed arrays, indexed by environment:
+// positions and velocities as x0, y0, x1, y1, ...
+class BatchEnv {
+public:
+    // threads = 0: one per core. The calling thread works too.
+    explicit BatchEnv(int count, int threads = 0);
+    ~BatchEnv();
+
+    int size() const { return static_cast<int>(engines.size()); }
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    // The same level in every environment (built in parallel)
+    void loadLevel(const LevelView &level);
+    void setTickRate(int ticksPerSecond);
+    void setAdaptiveStepping(bool enabled);
+    // Every environment, or one, back to the state right after loadLevel()
+    void reset();
+    void reset(int env);
+
+    // One tick everywhere; inputs holds 2 * size() calibrated values,
+    // x0, y0, x1, y1, ... as for PhysicsEngine::stepWithInput()
+    void step(const int16_t *inputs);
+
+    const float *positions() const { return position.data(); }
+    const float *velocities() const { return velocity.data(); }
+    // 1 where the ball is in the hole
+    const uint8_t *inHole() const { return holed.data(); }
+    // Times each ball went back to the start since loadLevel() (water, reset())
+    const uint32_t *respawns() const { return respawnCount.data(); }
+
+    // For callers that need more than the packed state (e.g. TiltBot); not
+    // to be used while step() runs
+    PhysicsEngine &engine(int env) { return *engines[env]; }
+    const PhysicsEngine &engine(int env) const { return *engines[env]; }
+
+private:
+    BatchEnv(const BatchEnv &);
+    BatchEnv &operator=(const BatchEnv &);
+
+    typedef void (BatchEnv::*Job)(int env);
+
+    // Run job on every environment across the pool; returns when all are done
+    void forEach(Job job);
+    void work();
+    void workerLoop();
+
+    void loadOne(int env);
+    void resetOne(int env);
+    void stepOne(int env);
+    void publish(int env);
+
+    std::vector<PhysicsEngine *> engines;
+    std::vector<float> position;
+    std::vector<float> velocity;
+    std::vector<uint8_t> holed;
+    std::vector<uint32_t> respawnCount;
+    std::vector<uint32_t> respawnBase;
+
+    // Arguments of the job in flight
+    const int16_t *pendingInputs;
+    const LevelView *pendingLevel;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    Job job;
+    uint64_t generation;         // bumped for each job
+    int running;                 // workers still inside the current job
+    bool stopping;
+    std::atomic<int> nextEnv;    // first unclaimed environment
+    int blockSize;
+};
+
+#endif
@@ -5,12 +5,20 @@
 INCLUDEPATH += $$PWD/Box2D/include $$PWD/Box2D/src
 CONFIG += c++11
 
+# Bit-identical simulation on x86 and ARM: qmake "CONFIG += deterministic_math"
+# Portable sin/cos/atan2 (b2_math.h) and no fused multiply-add contraction.
+deterministic_math {
+    DEFINES += B2_DETERMINISTIC_MATH
+    QMAKE_CXXFLAGS += -ffp-contract=off
+}
+
 # --- Dynamics ---
 SOURCES += \
     $$PWD/Box2D/src/dynamics/b2_body.cpp \
     $$PWD/Box2D/src/dynamics/b2_chain_circle_contact.cpp \
     $$PWD/Box2D/src/dynamics/b2_chain_polygon_contact.cpp \
     $$PWD/Box2D/src/dynamics/b2_circle_contact.cpp \
+    $$PWD/Box2D/src/dynamics/b2_contact_events.cpp \
     $$PWD/Box2D/src/dynamics/b2_contact_manager.cpp \
     $$PWD/Box2D/src/dynamics/b2_contact_solver.cpp \
     $$PWD/Box2D/src/dynamics/b2_contact.cpp \
@@ -51,6 +59,7 @@ SOURCES += \
 
 # --- Common ---
 SOURCES += \
+    $$PWD/Box2D/src/common/b2_arena_allocator.cpp \
     $$PWD/Box2D/src/common/b2_block_allocator.cpp \
     $$PWD/Box2D/src/common/b2_draw.cpp \
     $$PWD/Box2D/src/common/b2_math.cpp \
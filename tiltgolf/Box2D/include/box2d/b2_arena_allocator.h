@@ -0,0 +1,76 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_ARENA_ALLOCATOR_H
+#define B2_ARENA_ALLOCATOR_H
+
+#include "b2_api.h"
+#include "b2_settings.h"
+
+/// A linear arena for memory that lives as long as a level. Allocation is a
+/// pointer bump and there is no per-allocation free. Reset releases everything
+/// in O(1). Attach it to a b2World through b2WorldMemoryDef so the world's
+/// block allocator carves its chunks from the arena instead of the heap.
+/// The arena must outlive every world that uses it, and Reset may only be
+/// called once those worlds are destroyed.
+class B2_API b2ArenaAllocator
+{
+public:
+	/// Allocate a buffer of the given size with b2Alloc. The arena owns it.
+	b2ArenaAllocator(int32 capacity);
+
+	/// Use caller owned memory (e.g. static storage). The arena never frees it.
+	b2ArenaAllocator(void* memory, int32 capacity);
+
+	~b2ArenaAllocator();
+
+	/// Allocate memory. Returns nullptr when the arena is exhausted.
+	void* Allocate(int32 size);
+
+	/// Release all allocations at once.
+	void Reset();
+
+	int32 GetCapacity() const { return m_capacity; }
+
+	/// Bytes handed out since the last reset.
+	int32 GetUsed() const { return m_index; }
+
+	/// The most bytes ever in use at once.
+	int32 GetPeak() const { return m_peak; }
+
+	/// Number of requests that did not fit.
+	int32 GetFailedCount() const { return m_failedCount; }
+
+private:
+
+	b2ArenaAllocator(const b2ArenaAllocator&);
+	b2ArenaAllocator& operator=(const b2ArenaAllocator&);
+
+	char* m_data;
+	int32 m_capacity;
+	int32 m_index;
+	int32 m_peak;
+	int32 m_failedCount;
+	bool m_ownsData;
+};
+
+#endif
@@ -30,6 +30,19 @@ const int32 b2_blockSizeCount = 14;
 
 struct b2Block;
 struct b2Chunk;
+class b2ArenaAllocator;
+
+/// Memory usage of a block allocator, per size class.
+struct B2_API b2BlockAllocatorStats
+{
+	int32 blockSizes[b2_blockSizeCount];	///< the block size of each size class
+	int32 liveBytes[b2_blockSizeCount];		///< bytes currently handed out
+	int32 peakBytes[b2_blockSizeCount];		///< the most bytes ever handed out at once
+	int32 largeLiveBytes;					///< live allocations too big for a size class
+	int32 largePeakBytes;
+	int32 chunkBytes;						///< memory reserved for blocks (heap and arena)
+	int32 arenaChunkBytes;					///< the part of chunkBytes that came from an arena
+};
 
 /// This is a small object allocator used for allocating small
 /// objects that persist for more than one time step.
@@ -40,6 +53,10 @@ public:
 	b2BlockAllocator();
 	~b2BlockAllocator();
 
+	/// Take chunks from an arena instead of b2Alloc. Falls back to b2Alloc
+	/// when the arena is full. Must be set before the first allocation.
+	void SetArena(b2ArenaAllocator* arena);
+
 	/// Allocate memory. This will use b2Alloc if the size is larger than b2_maxBlockSize.
 	void* Allocate(int32 size);
 
@@ -48,6 +65,9 @@ public:
 
 	void Clear();
 
+	/// Get live and peak usage per size class.
+	void GetStats(b2BlockAllocatorStats* stats) const;
+
 private:
 
 	b2Chunk* m_chunks;
@@ -55,6 +75,14 @@ private:
 	int32 m_chunkSpace;
 
 	b2Block* m_freeLists[b2_blockSizeCount];
+
+	b2ArenaAllocator* m_arena;
+
+	int32 m_liveBytes[b2_blockSizeCount];
+	int32 m_peakBytes[b2_blockSizeCount];
+	int32 m_largeLiveBytes;
+	int32 m_largePeakBytes;
+	int32 m_arenaChunkCount;
 };
 
 #endif
@@ -108,6 +108,16 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Number of bytes SaveState writes (tree plus pending moves).
+	int32 GetStateSize() const;
+
+	/// Copy the tree and the move buffer into memory (GetStateSize bytes).
+	void SaveState(void* memory) const;
+
+	/// Restore a broad-phase saved by SaveState.
+	/// @return the number of bytes read.
+	int32 RestoreState(const void* memory);
+
 private:
 
 	friend class b2DynamicTree;
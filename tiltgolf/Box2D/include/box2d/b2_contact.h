@@ -36,6 +36,7 @@ class b2World;
 class b2BlockAllocator;
 class b2StackAllocator;
 class b2ContactListener;
+class b2ContactEvents;
 
 /// Friction mixing law. The idea is to allow either fixture to drive the friction to zero.
 /// For example, anything slides on ice.
@@ -208,7 +209,7 @@ protected:
 	b2Contact(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB);
 	virtual ~b2Contact() {}
 
-	void Update(b2ContactListener* listener);
+	void Update(b2ContactListener* listener, b2ContactEvents* events);
 
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
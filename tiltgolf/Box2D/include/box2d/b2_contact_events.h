@@ -0,0 +1,125 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_CONTACT_EVENTS_H
+#define B2_CONTACT_EVENTS_H
+
+#include "b2_api.h"
+#include "b2_math.h"
+
+class b2Contact;
+class b2Fixture;
+struct b2ContactVelocityConstraint;
+
+/// Two fixtures started or stopped touching.
+struct B2_API b2ContactTouchEvent
+{
+	b2Fixture* fixtureA;
+	b2Fixture* fixtureB;
+};
+
+/// A solid contact was resolved by the solver with a normal impulse above
+/// the hit threshold. The point and normal are in world coordinates and the
+/// normal points from fixture A to fixture B.
+struct B2_API b2ContactHitEvent
+{
+	b2Fixture* fixtureA;
+	b2Fixture* fixtureB;
+	b2Vec2 point;
+	b2Vec2 normal;
+	float normalImpulse;
+	float tangentImpulse;
+};
+
+/// Flat, preallocated buffers of contact events recorded during b2World::Step.
+/// This is an alternative to b2ContactListener: when a b2ContactEvents object is
+/// registered with the world, the contact listener is no longer called and
+/// begin/end/hit events are appended here instead. Read them after Step returns.
+/// The buffers are cleared at the start of every Step (unless auto clear is off)
+/// and never grow. Events that do not fit are dropped and counted.
+/// Note: pre-solve has no event equivalent because it cannot modify the contact.
+/// Note: events are only recorded inside Step. Contacts destroyed by DestroyBody or
+/// DestroyFixture do not produce end events.
+class B2_API b2ContactEvents
+{
+public:
+	/// @param capacity the maximum number of events of each kind per step.
+	b2ContactEvents(int32 capacity = 128);
+	~b2ContactEvents();
+
+	/// Only report hits with a normal impulse of at least this value. Default is zero.
+	void SetHitImpulseThreshold(float threshold) { m_hitThreshold = threshold; }
+	float GetHitImpulseThreshold() const { return m_hitThreshold; }
+
+	const b2ContactTouchEvent* GetBeginEvents() const { return m_beginEvents; }
+	int32 GetBeginEventCount() const { return m_beginCount; }
+
+	const b2ContactTouchEvent* GetEndEvents() const { return m_endEvents; }
+	int32 GetEndEventCount() const { return m_endCount; }
+
+	const b2ContactHitEvent* GetHitEvents() const { return m_hitEvents; }
+	int32 GetHitEventCount() const { return m_hitCount; }
+
+	/// Number of events dropped since the last clear because a buffer was full.
+	int32 GetDroppedEventCount() const { return m_droppedCount; }
+
+	/// Clear the buffers at the start of every Step. Turn this off to collect the
+	/// events of several sub-steps and call Clear yourself. Default is on.
+	void SetAutoClear(bool flag) { m_autoClear = flag; }
+	bool GetAutoClear() const { return m_autoClear; }
+
+	int32 GetCapacity() const { return m_capacity; }
+
+	/// Discard all recorded events.
+	void Clear();
+
+private:
+
+	friend class b2World;
+	friend class b2Contact;
+	friend class b2ContactManager;
+	friend class b2Island;
+
+	// Called by b2World::Step to bracket recording.
+	void BeginStep();
+	void EndStep();
+
+	void AddBegin(b2Contact* contact);
+	void AddEnd(b2Contact* contact);
+	void AddHits(b2Contact** contacts, const b2ContactVelocityConstraint* constraints, int32 count);
+
+	b2ContactTouchEvent* m_beginEvents;
+	b2ContactTouchEvent* m_endEvents;
+	b2ContactHitEvent* m_hitEvents;
+
+	int32 m_capacity;
+	int32 m_beginCount;
+	int32 m_endCount;
+	int32 m_hitCount;
+	int32 m_droppedCount;
+
+	float m_hitThreshold;
+	bool m_recording;
+	bool m_autoClear;
+};
+
+#endif
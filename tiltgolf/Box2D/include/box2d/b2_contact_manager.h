@@ -29,6 +29,7 @@
 class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
+class b2ContactEvents;
 class b2BlockAllocator;
 
 // Delegate of b2World.
@@ -51,6 +52,7 @@ public:
 	int32 m_contactCount;
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
+	b2ContactEvents* m_contactEvents;
 	b2BlockAllocator* m_allocator;
 };
 
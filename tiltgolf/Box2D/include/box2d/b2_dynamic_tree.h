@@ -133,6 +133,17 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Number of bytes SaveState writes for the tree as it is now.
+	int32 GetStateSize() const;
+
+	/// Copy the node pool, root and free list into memory (GetStateSize bytes).
+	void SaveState(void* memory) const;
+
+	/// Restore a tree saved by SaveState. Node ids are preserved, so the
+	/// proxy user data stored in the nodes must still be valid.
+	/// @return the number of bytes read.
+	int32 RestoreState(const void* memory);
+
 private:
 
 	int32 AllocateNode();
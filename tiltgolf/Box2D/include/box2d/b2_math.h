@@ -34,8 +34,33 @@ inline bool b2IsValid(float x)
 	return isfinite(x);
 }
 
+/// Portable sin, cos and atan2 built only from IEEE-754 add, multiply and
+/// divide, so they give the same bits on every CPU (unlike the C library).
+/// Used by B2_DETERMINISTIC_MATH builds.
+B2_API float b2DeterministicSin(float x);
+B2_API float b2DeterministicCos(float x);
+B2_API float b2DeterministicAtan2(float y, float x);
+
+// sqrtf is correctly rounded by IEEE-754 on every target, so it stays.
 #define	b2Sqrt(x)	sqrtf(x)
-#define	b2Atan2(y, x)	atan2f(y, x)
+
+#ifdef B2_DETERMINISTIC_MATH
+	#if defined(__FAST_MATH__)
+	#error "B2_DETERMINISTIC_MATH cannot be combined with -ffast-math"
+	#endif
+	#if defined(__i386__) && !defined(__SSE2_MATH__)
+	#error "B2_DETERMINISTIC_MATH needs -msse2 -mfpmath=sse on 32-bit x86 (x87 keeps excess precision)"
+	#endif
+	// Also compile with -ffp-contract=off, otherwise a target with FMA may fuse
+	// a * b + c and round differently from one without.
+	#define	b2Atan2(y, x)	b2DeterministicAtan2(y, x)
+	#define	b2Sin(x)	b2DeterministicSin(x)
+	#define	b2Cos(x)	b2DeterministicCos(x)
+#else
+	#define	b2Atan2(y, x)	atan2f(y, x)
+	#define	b2Sin(x)	sinf(x)
+	#define	b2Cos(x)	cosf(x)
+#endif
 
 /// A 2D column vector.
 struct B2_API b2Vec2
@@ -43,8 +68,8 @@ struct B2_API b2Vec2
 	/// Default constructor does nothing (for performance).
 	b2Vec2() {}
 
-	/// Construct using coordinates.
-	b2Vec2(float xIn, float yIn) : x(xIn), y(yIn) {}
+	/// Construct using coordinates. Usable in constant expressions.
+	constexpr b2Vec2(float xIn, float yIn) : x(xIn), y(yIn) {}
 
 	/// Set this vector to all zeros.
 	void SetZero() { x = 0.0f; y = 0.0f; }
@@ -292,16 +317,16 @@ struct B2_API b2Rot
 	explicit b2Rot(float angle)
 	{
 		/// TODO_ERIN optimize
-		s = sinf(angle);
-		c = cosf(angle);
+		s = b2Sin(angle);
+		c = b2Cos(angle);
 	}
 
 	/// Set using an angle in radians.
 	void Set(float angle)
 	{
 		/// TODO_ERIN optimize
-		s = sinf(angle);
-		c = cosf(angle);
+		s = b2Sin(angle);
+		c = b2Cos(angle);
 	}
 
 	/// Set to the identity rotation
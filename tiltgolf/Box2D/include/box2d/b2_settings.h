@@ -122,6 +122,35 @@ inline void b2Log(const char* string, ...)
 
 #endif // B2_USER_SETTINGS
 
+// Scoped profiling zones inside the solver. These compile to nothing unless
+// B2_PROFILE_ZONES is defined, in which case you must provide b2ZoneBegin
+// and b2ZoneEnd. Zone names must be string literals.
+#if defined(B2_PROFILE_ZONES)
+
+B2_API void b2ZoneBegin(const char* name);
+B2_API void b2ZoneEnd();
+
+struct b2ZoneScope
+{
+	b2ZoneScope(const char* name)
+	{
+		b2ZoneBegin(name);
+	}
+
+	~b2ZoneScope()
+	{
+		b2ZoneEnd();
+	}
+};
+
+#define b2_zone(name) b2ZoneScope b2_zoneScope(name)
+
+#else
+
+#define b2_zone(name)
+
+#endif // B2_PROFILE_ZONES
+
 #include "b2_common.h"
 
 #endif
@@ -26,7 +26,7 @@
 #include "b2_api.h"
 #include "b2_settings.h"
 
-const int32 b2_stackSize = 100 * 1024;	// 100k
+const int32 b2_stackSize = 100 * 1024;	// 100k, default capacity
 const int32 b2_maxStackEntries = 32;
 
 struct B2_API b2StackEntry
@@ -42,21 +42,37 @@ struct B2_API b2StackEntry
 class B2_API b2StackAllocator
 {
 public:
-	b2StackAllocator();
+	b2StackAllocator(int32 capacity = b2_stackSize);
 	~b2StackAllocator();
 
+	/// Allocate from the stack. Falls back to b2Alloc when the stack is full.
 	void* Allocate(int32 size);
 	void Free(void* p);
 
+	/// Replace the stack buffer with one of the given capacity.
+	/// Only valid while nothing is allocated (e.g. between time steps).
+	void Reserve(int32 capacity);
+
+	/// The high-water mark of bytes in use, including overflow allocations.
 	int32 GetMaxAllocation() const;
 
+	int32 GetCapacity() const { return m_capacity; }
+
+	/// Number of allocations that did not fit and went to b2Alloc.
+	int32 GetOverflowCount() const { return m_overflowCount; }
+
 private:
 
-	char m_data[b2_stackSize];
+	b2StackAllocator(const b2StackAllocator&);
+	b2StackAllocator& operator=(const b2StackAllocator&);
+
+	char* m_data;
+	int32 m_capacity;
 	int32 m_index;
 
 	int32 m_allocation;
 	int32 m_maxAllocation;
+	int32 m_overflowCount;
 
 	b2StackEntry m_entries[b2_maxStackEntries];
 	int32 m_entryCount;
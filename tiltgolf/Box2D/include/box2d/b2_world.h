@@ -39,6 +39,47 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2ContactEvents;
+class b2ArenaAllocator;
+
+/// Memory configuration used to construct a world.
+struct B2_API b2WorldMemoryDef
+{
+	b2WorldMemoryDef()
+	{
+		arena = nullptr;
+		stackSize = b2_stackSize;
+		growStack = true;
+	}
+
+	/// Optional arena for the world's small object chunks. This lets a game
+	/// drop all world memory in O(1) by resetting the arena after the world
+	/// is destroyed. The arena is owned by you and must outlive the world.
+	b2ArenaAllocator* arena;
+
+	/// Initial capacity of the per-step stack allocator in bytes.
+	int32 stackSize;
+
+	/// Grow the stack after a step whose high-water mark came close to the
+	/// capacity, so that later steps do not fall back to the heap.
+	bool growStack;
+};
+
+/// Hashes of the simulation state, one per category, so a mismatch between two
+/// runs says what diverged first. Equal hashes mean bitwise equal state.
+struct B2_API b2WorldHash
+{
+	uint64 transforms;	///< body transforms and sweeps
+	uint64 velocities;	///< linear and angular velocities
+	uint64 contacts;	///< contact flags, manifold points and impulses
+	uint64 sleep;		///< sleep timers and awake flags
+
+	bool operator==(const b2WorldHash& other) const
+	{
+		return transforms == other.transforms && velocities == other.velocities &&
+			contacts == other.contacts && sleep == other.sleep;
+	}
+};
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -50,6 +91,11 @@ public:
 	/// @param gravity the world gravity vector.
 	b2World(const b2Vec2& gravity);
 
+	/// Construct a world object with a custom memory configuration.
+	/// @param gravity the world gravity vector.
+	/// @param memoryDef the allocator setup, see b2WorldMemoryDef.
+	b2World(const b2Vec2& gravity, const b2WorldMemoryDef& memoryDef);
+
 	/// Destruct the world. All physics entities are destroyed and all heap memory is released.
 	~b2World();
 
@@ -66,6 +112,16 @@ public:
 	/// remain in scope.
 	void SetContactListener(b2ContactListener* listener);
 
+	/// Register flat contact event buffers. While set, the contact listener is
+	/// bypassed and begin/end/hit events are recorded into the buffers during Step.
+	/// The buffers are owned by you and must remain in scope. Pass nullptr to go
+	/// back to the contact listener.
+	/// @warning This function is locked during callbacks.
+	void SetContactEvents(b2ContactEvents* events);
+
+	/// Get the registered contact event buffers, if any.
+	const b2ContactEvents* GetContactEvents() const;
+
 	/// Register a routine for debug drawing. The debug draw functions are called
 	/// inside with b2World::DebugDraw method. The debug draw object is owned
 	/// by you and must remain in scope.
@@ -207,9 +263,44 @@ public:
 	/// Get the contact manager for testing.
 	const b2ContactManager& GetContactManager() const;
 
+	/// Get the per-step stack allocator to inspect its capacity and overflows.
+	const b2StackAllocator& GetStackAllocator() const;
+
 	/// Get the current profile.
 	const b2Profile& GetProfile() const;
 
+	/// Get live and peak small object memory per size class.
+	void GetMemoryStats(b2BlockAllocatorStats* stats) const;
+
+	/// Number of bytes SaveState needs right now. This changes with the number
+	/// of contacts, so leave some headroom when sizing a buffer.
+	int32 GetStateSize() const;
+
+	/// Copy all mutable simulation state into a flat buffer: body transforms,
+	/// sweeps, velocities, forces and sleep timers, fixture proxy bounds,
+	/// contacts with their manifolds and warm starting impulses, and the
+	/// broad-phase tree. The buffer must be 8-byte aligned. The snapshot holds
+	/// pointers into this world, so it is only valid for this world and only
+	/// while no bodies or fixtures are created or destroyed. Joints are not
+	/// captured; worlds with joints are rejected.
+	/// @warning this should be called outside of a time step.
+	/// @return the number of bytes written, or 0 if the buffer is too small
+	/// or the world cannot be saved.
+	int32 SaveState(void* buffer, int32 capacity) const;
+
+	/// Restore a snapshot taken by SaveState. Stepping afterwards gives the same
+	/// results, bit for bit, as stepping from the moment of the save. No
+	/// listener or contact event is reported for the contacts that are
+	/// replaced.
+	/// @warning this should be called outside of a time step.
+	/// @return false if the snapshot does not belong to this world.
+	bool RestoreState(const void* buffer, int32 size);
+
+	/// Hash the state that decides the next step, bit for bit. Cheap enough to
+	/// call every step; use it to check that two runs stay identical, e.g. the
+	/// same replay on different CPUs.
+	void GetStateHash(b2WorldHash* hash) const;
+
 	/// Dump the world into the log file.
 	/// @warning this should be called outside of a time step.
 	void Dump();
@@ -226,6 +317,8 @@ private:
 
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
+	int32 CountFixtureProxies() const;
+
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
 
@@ -257,6 +350,7 @@ private:
 	bool m_subStepping;
 
 	bool m_stepComplete;
+	bool m_growStack;
 
 	b2Profile m_profile;
 };
@@ -337,6 +431,16 @@ inline const b2ContactManager& b2World::GetContactManager() const
 	return m_contactManager;
 }
 
+inline const b2ContactEvents* b2World::GetContactEvents() const
+{
+	return m_contactManager.m_contactEvents;
+}
+
+inline const b2StackAllocator& b2World::GetStackAllocator() const
+{
+	return m_stackAllocator;
+}
+
 inline const b2Profile& b2World::GetProfile() const
 {
 	return m_profile;
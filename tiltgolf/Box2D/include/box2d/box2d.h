@@ -26,6 +26,7 @@
 // These include files constitute the main Box2D API
 
 #include "b2_settings.h"
+#include "b2_arena_allocator.h"
 #include "b2_draw.h"
 #include "b2_timer.h"
 
@@ -39,6 +40,7 @@
 
 #include "b2_body.h"
 #include "b2_contact.h"
+#include "b2_contact_events.h"
 #include "b2_fixture.h"
 #include "b2_time_step.h"
 #include "b2_world.h"
@@ -129,3 +129,57 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 
 	return true;
 }
+
+struct b2BroadPhaseStateHeader
+{
+	int32 proxyCount;
+	int32 moveCount;
+};
+
+// Keeps whatever follows the move buffer 8-byte aligned
+static inline int32 b2AlignState(int32 size)
+{
+	return (size + 7) & ~7;
+}
+
+int32 b2BroadPhase::GetStateSize() const
+{
+	return int32(sizeof(b2BroadPhaseStateHeader)) + m_tree.GetStateSize() +
+		b2AlignState(m_moveCount * int32(sizeof(int32)));
+}
+
+void b2BroadPhase::SaveState(void* memory) const
+{
+	uint8* p = (uint8*)memory;
+	b2BroadPhaseStateHeader* header = (b2BroadPhaseStateHeader*)p;
+	header->proxyCount = m_proxyCount;
+	header->moveCount = m_moveCount;
+	p += sizeof(b2BroadPhaseStateHeader);
+
+	m_tree.SaveState(p);
+	p += m_tree.GetStateSize();
+
+	memcpy(p, m_moveBuffer, m_moveCount * sizeof(int32));
+}
+
+int32 b2BroadPhase::RestoreState(const void* memory)
+{
+	const uint8* p = (const uint8*)memory;
+	const b2BroadPhaseStateHeader* header = (const b2BroadPhaseStateHeader*)p;
+	p += sizeof(b2BroadPhaseStateHeader);
+
+	p += m_tree.RestoreState(p);
+
+	m_proxyCount = header->proxyCount;
+	if (m_moveCapacity < header->moveCount)
+	{
+		b2Free(m_moveBuffer);
+		m_moveCapacity = header->moveCount;
+		m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+	}
+	m_moveCount = header->moveCount;
+	memcpy(m_moveBuffer, p, m_moveCount * sizeof(int32));
+	p += b2AlignState(m_moveCount * int32(sizeof(int32)));
+
+	return int32(p - (const uint8*)memory);
+}
@@ -27,7 +27,8 @@
 #include "box2d/b2_polygon_shape.h"
 
 // GJK using Voronoi regions (Christer Ericson) and Barycentric coordinates.
-B2_API int32 b2_gjkCalls, b2_gjkIters, b2_gjkMaxIters;
+// Statistics per thread: separate worlds may step on several threads at once
+B2_API thread_local int32 b2_gjkCalls, b2_gjkIters, b2_gjkMaxIters;
 
 void b2DistanceProxy::Set(const b2Shape* shape, int32 index)
 {
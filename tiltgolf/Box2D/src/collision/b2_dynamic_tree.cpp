@@ -799,3 +799,81 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 		m_nodes[i].aabb.upperBound -= newOrigin;
 	}
 }
+
+// Fixed-size header in front of the saved node pool (keeps the nodes 8-byte aligned)
+struct b2TreeStateHeader
+{
+	int32 root;
+	int32 nodeCount;
+	int32 nodeCapacity;
+	int32 freeList;
+	int32 insertionCount;
+	int32 padding;
+};
+
+int32 b2DynamicTree::GetStateSize() const
+{
+	return int32(sizeof(b2TreeStateHeader) + m_nodeCapacity * sizeof(b2TreeNode));
+}
+
+void b2DynamicTree::SaveState(void* memory) const
+{
+	b2TreeStateHeader* header = (b2TreeStateHeader*)memory;
+	header->root = m_root;
+	header->nodeCount = m_nodeCount;
+	header->nodeCapacity = m_nodeCapacity;
+	header->freeList = m_freeList;
+	header->insertionCount = m_insertionCount;
+	header->padding = 0;
+	memcpy(header + 1, m_nodes, m_nodeCapacity * sizeof(b2TreeNode));
+}
+
+int32 b2DynamicTree::RestoreState(const void* memory)
+{
+	const b2TreeStateHeader* header = (const b2TreeStateHeader*)memory;
+	int32 savedCapacity = header->nodeCapacity;
+
+	if (m_nodeCapacity < savedCapacity)
+	{
+		b2Free(m_nodes);
+		m_nodeCapacity = savedCapacity;
+		m_nodes = (b2TreeNode*)b2Alloc(m_nodeCapacity * sizeof(b2TreeNode));
+	}
+
+	const b2TreeNode* savedNodes = (const b2TreeNode*)(header + 1);
+	memcpy(m_nodes, savedNodes, savedCapacity * sizeof(b2TreeNode));
+	m_root = header->root;
+	m_nodeCount = header->nodeCount;
+	m_freeList = header->freeList;
+	m_insertionCount = header->insertionCount;
+
+	if (m_nodeCapacity > savedCapacity)
+	{
+		// The pool grew after the save. Append the extra nodes to the end of the
+		// saved free list in index order, which is the order a grown pool would
+		// hand them out, so proxy ids come out the same as in the original run.
+		for (int32 i = savedCapacity; i < m_nodeCapacity - 1; ++i)
+		{
+			m_nodes[i].next = i + 1;
+			m_nodes[i].height = -1;
+		}
+		m_nodes[m_nodeCapacity - 1].next = b2_nullNode;
+		m_nodes[m_nodeCapacity - 1].height = -1;
+
+		if (m_freeList == b2_nullNode)
+		{
+			m_freeList = savedCapacity;
+		}
+		else
+		{
+			int32 tail = m_freeList;
+			while (m_nodes[tail].next != b2_nullNode)
+			{
+				tail = m_nodes[tail].next;
+			}
+			m_nodes[tail].next = savedCapacity;
+		}
+	}
+
+	return int32(sizeof(b2TreeStateHeader) + savedCapacity * sizeof(b2TreeNode));
+}
@@ -29,9 +29,10 @@
 
 #include <stdio.h>
 
-B2_API float b2_toiTime, b2_toiMaxTime;
-B2_API int32 b2_toiCalls, b2_toiIters, b2_toiMaxIters;
-B2_API int32 b2_toiRootIters, b2_toiMaxRootIters;
+// Statistics per thread: separate worlds may step on several threads at once
+B2_API thread_local float b2_toiTime, b2_toiMaxTime;
+B2_API thread_local int32 b2_toiCalls, b2_toiIters, b2_toiMaxIters;
+B2_API thread_local int32 b2_toiRootIters, b2_toiMaxRootIters;
 
 //
 struct b2SeparationFunction
@@ -0,0 +1,84 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "box2d/b2_arena_allocator.h"
+#include "box2d/b2_math.h"
+
+#include <stddef.h>
+
+// Keep every allocation aligned for the largest scalar type.
+static const int32 b2_arenaAlignment = 16;
+
+b2ArenaAllocator::b2ArenaAllocator(int32 capacity)
+{
+	b2Assert(capacity > 0);
+	m_data = (char*)b2Alloc(capacity);
+	m_capacity = capacity;
+	m_index = 0;
+	m_peak = 0;
+	m_failedCount = 0;
+	m_ownsData = true;
+}
+
+b2ArenaAllocator::b2ArenaAllocator(void* memory, int32 capacity)
+{
+	b2Assert(memory != nullptr && capacity > 0);
+	m_data = (char*)memory;
+	m_capacity = capacity;
+	m_index = 0;
+	m_peak = 0;
+	m_failedCount = 0;
+	m_ownsData = false;
+}
+
+b2ArenaAllocator::~b2ArenaAllocator()
+{
+	if (m_ownsData)
+	{
+		b2Free(m_data);
+	}
+}
+
+void* b2ArenaAllocator::Allocate(int32 size)
+{
+	b2Assert(size > 0);
+
+	// Align relative to the actual address in case the caller's buffer is not aligned.
+	uintptr_t address = (uintptr_t)(m_data + m_index);
+	int32 padding = (int32)((b2_arenaAlignment - (address & (b2_arenaAlignment - 1))) & (b2_arenaAlignment - 1));
+
+	if (size > m_capacity - m_index - padding)
+	{
+		++m_failedCount;
+		return nullptr;
+	}
+
+	char* p = m_data + m_index + padding;
+	m_index += padding + size;
+	m_peak = b2Max(m_peak, m_index);
+	return p;
+}
+
+void b2ArenaAllocator::Reset()
+{
+	m_index = 0;
+}
@@ -20,7 +20,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include "box2d/b2_arena_allocator.h"
 #include "box2d/b2_block_allocator.h"
+#include "box2d/b2_math.h"
 #include <limits.h>
 #include <string.h>
 #include <stddef.h>
@@ -79,6 +81,7 @@ struct b2Chunk
 {
 	int32 blockSize;
 	b2Block* blocks;
+	bool usedArena;
 };
 
 struct b2Block
@@ -96,18 +99,36 @@ b2BlockAllocator::b2BlockAllocator()
 	
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 	memset(m_freeLists, 0, sizeof(m_freeLists));
+
+	m_arena = nullptr;
+
+	memset(m_liveBytes, 0, sizeof(m_liveBytes));
+	memset(m_peakBytes, 0, sizeof(m_peakBytes));
+	m_largeLiveBytes = 0;
+	m_largePeakBytes = 0;
+	m_arenaChunkCount = 0;
 }
 
 b2BlockAllocator::~b2BlockAllocator()
 {
+	// Arena chunks are released in bulk by the arena.
 	for (int32 i = 0; i < m_chunkCount; ++i)
 	{
-		b2Free(m_chunks[i].blocks);
+		if (m_chunks[i].usedArena == false)
+		{
+			b2Free(m_chunks[i].blocks);
+		}
 	}
 
 	b2Free(m_chunks);
 }
 
+void b2BlockAllocator::SetArena(b2ArenaAllocator* arena)
+{
+	b2Assert(m_chunkCount == 0);
+	m_arena = arena;
+}
+
 void* b2BlockAllocator::Allocate(int32 size)
 {
 	if (size == 0)
@@ -119,12 +140,17 @@ void* b2BlockAllocator::Allocate(int32 size)
 
 	if (size > b2_maxBlockSize)
 	{
+		m_largeLiveBytes += size;
+		m_largePeakBytes = b2Max(m_largePeakBytes, m_largeLiveBytes);
 		return b2Alloc(size);
 	}
 
 	int32 index = b2_sizeMap.values[size];
 	b2Assert(0 <= index && index < b2_blockSizeCount);
 
+	m_liveBytes[index] += b2_blockSizes[index];
+	m_peakBytes[index] = b2Max(m_peakBytes[index], m_liveBytes[index]);
+
 	if (m_freeLists[index])
 	{
 		b2Block* block = m_freeLists[index];
@@ -144,7 +170,21 @@ void* b2BlockAllocator::Allocate(int32 size)
 		}
 
 		b2Chunk* chunk = m_chunks + m_chunkCount;
-		chunk->blocks = (b2Block*)b2Alloc(b2_chunkSize);
+		chunk->blocks = nullptr;
+		if (m_arena)
+		{
+			chunk->blocks = (b2Block*)m_arena->Allocate(b2_chunkSize);
+		}
+
+		chunk->usedArena = chunk->blocks != nullptr;
+		if (chunk->usedArena)
+		{
+			++m_arenaChunkCount;
+		}
+		else
+		{
+			chunk->blocks = (b2Block*)b2Alloc(b2_chunkSize);
+		}
 #if defined(_DEBUG)
 		memset(chunk->blocks, 0xcd, b2_chunkSize);
 #endif
@@ -179,6 +219,7 @@ void b2BlockAllocator::Free(void* p, int32 size)
 
 	if (size > b2_maxBlockSize)
 	{
+		m_largeLiveBytes -= size;
 		b2Free(p);
 		return;
 	}
@@ -186,6 +227,8 @@ void b2BlockAllocator::Free(void* p, int32 size)
 	int32 index = b2_sizeMap.values[size];
 	b2Assert(0 <= index && index < b2_blockSizeCount);
 
+	m_liveBytes[index] -= b2_blockSizes[index];
+
 #if defined(_DEBUG)
 	// Verify the memory address and size is valid.
 	int32 blockSize = b2_blockSizes[index];
@@ -221,10 +264,30 @@ void b2BlockAllocator::Clear()
 {
 	for (int32 i = 0; i < m_chunkCount; ++i)
 	{
-		b2Free(m_chunks[i].blocks);
+		if (m_chunks[i].usedArena == false)
+		{
+			b2Free(m_chunks[i].blocks);
+		}
 	}
 
 	m_chunkCount = 0;
+	m_arenaChunkCount = 0;
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 	memset(m_freeLists, 0, sizeof(m_freeLists));
+	memset(m_liveBytes, 0, sizeof(m_liveBytes));
+}
+
+void b2BlockAllocator::GetStats(b2BlockAllocatorStats* stats) const
+{
+	for (int32 i = 0; i < b2_blockSizeCount; ++i)
+	{
+		stats->blockSizes[i] = b2_blockSizes[i];
+		stats->liveBytes[i] = m_liveBytes[i];
+		stats->peakBytes[i] = m_peakBytes[i];
+	}
+
+	stats->largeLiveBytes = m_largeLiveBytes;
+	stats->largePeakBytes = m_largePeakBytes;
+	stats->chunkBytes = m_chunkCount * b2_chunkSize;
+	stats->arenaChunkBytes = m_arenaChunkCount * b2_chunkSize;
 }
@@ -96,3 +96,127 @@ void b2Mat33::GetSymInverse33(b2Mat33* M) const
 	M->ez.y = M->ey.z;
 	M->ez.z = det * (a11 * a22 - a12 * a12);
 }
+
+// Deterministic transcendentals. The work is done in double precision (exact
+// on every IEEE-754 target when contraction is off) with the fdlibm kernels,
+// then rounded once to float, so results are also within an ulp of sinf/cosf.
+
+static const double b2_pio2Hi = 1.57079632673412561417e+00;	// first 33 bits of pi/2
+static const double b2_pio2Lo = 6.07710050650619224932e-11;	// pi/2 - b2_pio2Hi
+static const double b2_twoOverPi = 6.36619772367581382433e-01;
+
+// sin(r) for |r| <= pi/4
+static inline double b2KernelSin(double r)
+{
+	const double S1 = -1.66666666666666324348e-01;
+	const double S2 = 8.33333333332248946124e-03;
+	const double S3 = -1.98412698298579493134e-04;
+	const double S4 = 2.75573137070700676789e-06;
+	const double S5 = -2.50507602534068634195e-08;
+	const double S6 = 1.58969099521155010221e-10;
+	double z = r * r;
+	return r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+}
+
+// cos(r) for |r| <= pi/4
+static inline double b2KernelCos(double r)
+{
+	const double C1 = 4.16666666666666019037e-02;
+	const double C2 = -1.38888888888741095749e-03;
+	const double C3 = 2.48015872894767294178e-05;
+	const double C4 = -2.75573143513906633035e-07;
+	const double C5 = 2.08757232129817482790e-09;
+	const double C6 = -1.13596475577881948265e-11;
+	double z = r * r;
+	return 1.0 - 0.5 * z + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+}
+
+// Reduce x to r in [-pi/4, pi/4] and the quadrant x = r + quadrant * pi/2
+static inline double b2ReduceAngle(float x, int32* quadrant)
+{
+	double k = floor(double(x) * b2_twoOverPi + 0.5);
+	*quadrant = int32((long long)k & 3);
+	return (double(x) - k * b2_pio2Hi) - k * b2_pio2Lo;
+}
+
+float b2DeterministicSin(float x)
+{
+	int32 quadrant;
+	double r = b2ReduceAngle(x, &quadrant);
+	switch (quadrant)
+	{
+	case 0: return float(b2KernelSin(r));
+	case 1: return float(b2KernelCos(r));
+	case 2: return float(-b2KernelSin(r));
+	default: return float(-b2KernelCos(r));
+	}
+}
+
+float b2DeterministicCos(float x)
+{
+	int32 quadrant;
+	double r = b2ReduceAngle(x, &quadrant);
+	switch (quadrant)
+	{
+	case 0: return float(b2KernelCos(r));
+	case 1: return float(-b2KernelSin(r));
+	case 2: return float(-b2KernelCos(r));
+	default: return float(b2KernelSin(r));
+	}
+}
+
+// atan(t) for |t| <= tan(pi/8)
+static inline double b2KernelAtan(double t)
+{
+	const double aT[11] =
+	{
+		3.33333333333329318027e-01, -1.99999999998764832476e-01, 1.42857142725034663711e-01,
+		-1.11111104054623557880e-01, 9.09088713343650656196e-02, -7.69187620504482999495e-02,
+		6.66107313738753120669e-02, -5.83357013379057348645e-02, 4.97687799461593236017e-02,
+		-3.65315727442169155270e-02, 1.62858201153657823623e-02
+	};
+	double z = t * t;
+	double w = z * z;
+	double s1 = z * (aT[0] + w * (aT[2] + w * (aT[4] + w * (aT[6] + w * (aT[8] + w * aT[10])))));
+	double s2 = w * (aT[1] + w * (aT[3] + w * (aT[5] + w * (aT[7] + w * aT[9]))));
+	return t - t * (s1 + s2);
+}
+
+float b2DeterministicAtan2(float y, float x)
+{
+	const double pi = 3.14159265358979311600e+00;
+	const double pio2 = 1.57079632679489655800e+00;
+	const double pio4 = 7.85398163397448278999e-01;
+	const double tanPio8 = 4.14213562373095145475e-01;
+
+	double ax = fabs(double(x));
+	double ay = fabs(double(y));
+	if (ax == 0.0 && ay == 0.0)
+	{
+		// Matches atan2f for +-0 arguments
+		return (x < 0.0f || (x == 0.0f && signbit(x))) ? (signbit(y) ? -float(pi) : float(pi)) : y;
+	}
+
+	// Angle in [0, pi/4] of the smaller over the larger component
+	bool swapped = ay > ax;
+	double t = swapped ? ax / ay : ay / ax;
+	double a;
+	if (t > tanPio8)
+	{
+		a = pio4 + b2KernelAtan((t - 1.0) / (t + 1.0));
+	}
+	else
+	{
+		a = b2KernelAtan(t);
+	}
+
+	if (swapped)
+	{
+		a = pio2 - a;
+	}
+	if (x < 0.0f)
+	{
+		a = pi - a;
+	}
+	return float(signbit(y) ? -a : a);
+}
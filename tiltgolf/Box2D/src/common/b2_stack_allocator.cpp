@@ -23,11 +23,15 @@
 #include "box2d/b2_stack_allocator.h"
 #include "box2d/b2_math.h"
 
-b2StackAllocator::b2StackAllocator()
+b2StackAllocator::b2StackAllocator(int32 capacity)
 {
+	b2Assert(capacity > 0);
+	m_data = (char*)b2Alloc(capacity);
+	m_capacity = capacity;
 	m_index = 0;
 	m_allocation = 0;
 	m_maxAllocation = 0;
+	m_overflowCount = 0;
 	m_entryCount = 0;
 }
 
@@ -35,6 +39,21 @@ b2StackAllocator::~b2StackAllocator()
 {
 	b2Assert(m_index == 0);
 	b2Assert(m_entryCount == 0);
+	b2Free(m_data);
+}
+
+void b2StackAllocator::Reserve(int32 capacity)
+{
+	b2Assert(m_entryCount == 0);
+	b2Assert(capacity > 0);
+	if (m_entryCount != 0 || capacity == m_capacity)
+	{
+		return;
+	}
+
+	b2Free(m_data);
+	m_data = (char*)b2Alloc(capacity);
+	m_capacity = capacity;
 }
 
 void* b2StackAllocator::Allocate(int32 size)
@@ -43,10 +62,11 @@ void* b2StackAllocator::Allocate(int32 size)
 
 	b2StackEntry* entry = m_entries + m_entryCount;
 	entry->size = size;
-	if (m_index + size > b2_stackSize)
+	if (m_index + size > m_capacity)
 	{
 		entry->data = (char*)b2Alloc(size);
 		entry->usedMalloc = true;
+		++m_overflowCount;
 	}
 	else
 	{
@@ -30,6 +30,7 @@
 #include "b2_polygon_contact.h"
 
 #include "box2d/b2_contact.h"
+#include "box2d/b2_contact_events.h"
 #include "box2d/b2_block_allocator.h"
 #include "box2d/b2_body.h"
 #include "box2d/b2_collision.h"
@@ -38,9 +39,15 @@
 #include "box2d/b2_time_of_impact.h"
 #include "box2d/b2_world.h"
 
+#include <mutex>
+
 b2ContactRegister b2Contact::s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 bool b2Contact::s_initialized = false;
 
+// Worlds may be stepped on several threads at once, so the first contact on
+// any of them fills the table, exactly once, before any thread reads it.
+static std::once_flag s_registersOnce;
+
 void b2Contact::InitializeRegisters()
 {
 	AddType(b2CircleContact::Create, b2CircleContact::Destroy, b2Shape::e_circle, b2Shape::e_circle);
@@ -50,6 +57,7 @@ void b2Contact::InitializeRegisters()
 	AddType(b2EdgeAndPolygonContact::Create, b2EdgeAndPolygonContact::Destroy, b2Shape::e_edge, b2Shape::e_polygon);
 	AddType(b2ChainAndCircleContact::Create, b2ChainAndCircleContact::Destroy, b2Shape::e_chain, b2Shape::e_circle);
 	AddType(b2ChainAndPolygonContact::Create, b2ChainAndPolygonContact::Destroy, b2Shape::e_chain, b2Shape::e_polygon);
+	s_initialized = true;
 }
 
 void b2Contact::AddType(b2ContactCreateFcn* createFcn, b2ContactDestroyFcn* destoryFcn,
@@ -72,11 +80,7 @@ void b2Contact::AddType(b2ContactCreateFcn* createFcn, b2ContactDestroyFcn* dest
 
 b2Contact* b2Contact::Create(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB, b2BlockAllocator* allocator)
 {
-	if (s_initialized == false)
-	{
-		InitializeRegisters();
-		s_initialized = true;
-	}
+	std::call_once(s_registersOnce, InitializeRegisters);
 
 	b2Shape::Type type1 = fixtureA->GetType();
 	b2Shape::Type type2 = fixtureB->GetType();
@@ -163,7 +167,7 @@ b2Contact::b2Contact(b2Fixture* fA, int32 indexA, b2Fixture* fB, int32 indexB)
 
 // Update the contact manifold and touching status.
 // Note: do not assume the fixture AABBs are overlapping or are valid.
-void b2Contact::Update(b2ContactListener* listener)
+void b2Contact::Update(b2ContactListener* listener, b2ContactEvents* events)
 {
 	b2Manifold oldManifold = m_manifold;
 
@@ -235,6 +239,22 @@ void b2Contact::Update(b2ContactListener* listener)
 		m_flags &= ~e_touchingFlag;
 	}
 
+	// Buffered events replace the listener entirely.
+	if (events)
+	{
+		if (wasTouching == false && touching == true)
+		{
+			events->AddBegin(this);
+		}
+
+		if (wasTouching == true && touching == false)
+		{
+			events->AddEnd(this);
+		}
+
+		return;
+	}
+
 	if (wasTouching == false && touching == true && listener)
 	{
 		listener->BeginContact(this);
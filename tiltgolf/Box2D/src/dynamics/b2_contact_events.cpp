@@ -0,0 +1,159 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "b2_contact_solver.h"
+
+#include "box2d/b2_contact.h"
+#include "box2d/b2_contact_events.h"
+#include "box2d/b2_settings.h"
+
+b2ContactEvents::b2ContactEvents(int32 capacity)
+{
+	b2Assert(capacity > 0);
+	m_capacity = capacity;
+	m_beginEvents = (b2ContactTouchEvent*)b2Alloc(capacity * sizeof(b2ContactTouchEvent));
+	m_endEvents = (b2ContactTouchEvent*)b2Alloc(capacity * sizeof(b2ContactTouchEvent));
+	m_hitEvents = (b2ContactHitEvent*)b2Alloc(capacity * sizeof(b2ContactHitEvent));
+
+	m_beginCount = 0;
+	m_endCount = 0;
+	m_hitCount = 0;
+	m_droppedCount = 0;
+
+	m_hitThreshold = 0.0f;
+	m_recording = false;
+	m_autoClear = true;
+}
+
+b2ContactEvents::~b2ContactEvents()
+{
+	b2Free(m_hitEvents);
+	b2Free(m_endEvents);
+	b2Free(m_beginEvents);
+}
+
+void b2ContactEvents::Clear()
+{
+	m_beginCount = 0;
+	m_endCount = 0;
+	m_hitCount = 0;
+	m_droppedCount = 0;
+}
+
+void b2ContactEvents::BeginStep()
+{
+	if (m_autoClear)
+	{
+		Clear();
+	}
+	m_recording = true;
+}
+
+void b2ContactEvents::EndStep()
+{
+	m_recording = false;
+}
+
+void b2ContactEvents::AddBegin(b2Contact* contact)
+{
+	if (m_recording == false)
+	{
+		return;
+	}
+
+	if (m_beginCount == m_capacity)
+	{
+		++m_droppedCount;
+		return;
+	}
+
+	b2ContactTouchEvent* event = m_beginEvents + m_beginCount++;
+	event->fixtureA = contact->GetFixtureA();
+	event->fixtureB = contact->GetFixtureB();
+}
+
+void b2ContactEvents::AddEnd(b2Contact* contact)
+{
+	if (m_recording == false)
+	{
+		return;
+	}
+
+	if (m_endCount == m_capacity)
+	{
+		++m_droppedCount;
+		return;
+	}
+
+	b2ContactTouchEvent* event = m_endEvents + m_endCount++;
+	event->fixtureA = contact->GetFixtureA();
+	event->fixtureB = contact->GetFixtureB();
+}
+
+void b2ContactEvents::AddHits(b2Contact** contacts, const b2ContactVelocityConstraint* constraints, int32 count)
+{
+	if (m_recording == false)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		const b2ContactVelocityConstraint* vc = constraints + i;
+
+		// Use the strongest point of the manifold as the hit location.
+		int32 bestIndex = -1;
+		float bestImpulse = m_hitThreshold;
+		for (int32 j = 0; j < vc->pointCount; ++j)
+		{
+			float impulse = vc->points[j].normalImpulse;
+			if (impulse > 0.0f && impulse >= bestImpulse)
+			{
+				bestImpulse = impulse;
+				bestIndex = j;
+			}
+		}
+
+		if (bestIndex == -1)
+		{
+			continue;
+		}
+
+		if (m_hitCount == m_capacity)
+		{
+			++m_droppedCount;
+			continue;
+		}
+
+		b2Contact* c = contacts[i];
+		b2WorldManifold worldManifold;
+		c->GetWorldManifold(&worldManifold);
+
+		b2ContactHitEvent* event = m_hitEvents + m_hitCount++;
+		event->fixtureA = c->GetFixtureA();
+		event->fixtureB = c->GetFixtureB();
+		event->point = worldManifold.points[bestIndex];
+		event->normal = vc->normal;
+		event->normalImpulse = vc->points[bestIndex].normalImpulse;
+		event->tangentImpulse = vc->points[bestIndex].tangentImpulse;
+	}
+}
@@ -22,6 +22,7 @@
 
 #include "box2d/b2_body.h"
 #include "box2d/b2_contact.h"
+#include "box2d/b2_contact_events.h"
 #include "box2d/b2_contact_manager.h"
 #include "box2d/b2_fixture.h"
 #include "box2d/b2_world_callbacks.h"
@@ -35,6 +36,7 @@ b2ContactManager::b2ContactManager()
 	m_contactCount = 0;
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
+	m_contactEvents = nullptr;
 	m_allocator = nullptr;
 }
 
@@ -45,7 +47,14 @@ void b2ContactManager::Destroy(b2Contact* c)
 	b2Body* bodyA = fixtureA->GetBody();
 	b2Body* bodyB = fixtureB->GetBody();
 
-	if (m_contactListener && c->IsTouching())
+	if (m_contactEvents)
+	{
+		if (c->IsTouching())
+		{
+			m_contactEvents->AddEnd(c);
+		}
+	}
+	else if (m_contactListener && c->IsTouching())
 	{
 		m_contactListener->EndContact(c);
 	}
@@ -108,6 +117,8 @@ void b2ContactManager::Destroy(b2Contact* c)
 // contact list.
 void b2ContactManager::Collide()
 {
+	b2_zone("b2ContactManager::Collide");
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -168,7 +179,7 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		c->Update(m_contactListener, m_contactEvents);
 		c = c->GetNext();
 	}
 }
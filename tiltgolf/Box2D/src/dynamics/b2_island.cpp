@@ -22,6 +22,7 @@
 
 #include "box2d/b2_body.h"
 #include "box2d/b2_contact.h"
+#include "box2d/b2_contact_events.h"
 #include "box2d/b2_distance.h"
 #include "box2d/b2_fixture.h"
 #include "box2d/b2_joint.h"
@@ -155,7 +156,8 @@ b2Island::b2Island(
 	int32 contactCapacity,
 	int32 jointCapacity,
 	b2StackAllocator* allocator,
-	b2ContactListener* listener)
+	b2ContactListener* listener,
+	b2ContactEvents* events)
 {
 	m_bodyCapacity = bodyCapacity;
 	m_contactCapacity = contactCapacity;
@@ -166,6 +168,7 @@ b2Island::b2Island(
 
 	m_allocator = allocator;
 	m_listener = listener;
+	m_events = events;
 
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
@@ -520,6 +523,12 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
+	if (m_events)
+	{
+		m_events->AddHits(m_contacts, constraints, m_contactCount);
+		return;
+	}
+
 	if (m_listener == nullptr)
 	{
 		return;
@@ -31,6 +31,7 @@ class b2Contact;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
+class b2ContactEvents;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
 
@@ -39,7 +40,7 @@ class b2Island
 {
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
-			b2StackAllocator* allocator, b2ContactListener* listener);
+			b2StackAllocator* allocator, b2ContactListener* listener, b2ContactEvents* events);
 	~b2Island();
 
 	void Clear()
@@ -77,6 +78,7 @@ public:
 
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
+	b2ContactEvents* m_events;
 
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
@@ -29,6 +29,7 @@
 #include "box2d/b2_circle_shape.h"
 #include "box2d/b2_collision.h"
 #include "box2d/b2_contact.h"
+#include "box2d/b2_contact_events.h"
 #include "box2d/b2_draw.h"
 #include "box2d/b2_edge_shape.h"
 #include "box2d/b2_fixture.h"
@@ -41,7 +42,16 @@
 #include <new>
 
 b2World::b2World(const b2Vec2& gravity)
+	: b2World(gravity, b2WorldMemoryDef())
 {
+}
+
+b2World::b2World(const b2Vec2& gravity, const b2WorldMemoryDef& memoryDef)
+	: m_stackAllocator(memoryDef.stackSize)
+{
+	m_blockAllocator.SetArena(memoryDef.arena);
+	m_growStack = memoryDef.growStack;
+
 	m_destructionListener = nullptr;
 	m_debugDraw = nullptr;
 
@@ -107,6 +117,12 @@ void b2World::SetContactListener(b2ContactListener* listener)
 	m_contactManager.m_contactListener = listener;
 }
 
+void b2World::SetContactEvents(b2ContactEvents* events)
+{
+	b2Assert(IsLocked() == false);
+	m_contactManager.m_contactEvents = events;
+}
+
 void b2World::SetDebugDraw(b2Draw* debugDraw)
 {
 	m_debugDraw = debugDraw;
@@ -393,6 +409,8 @@ void b2World::SetAllowSleeping(bool flag)
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
+	b2_zone("b2World::Solve");
+
 	m_profile.solveInit = 0.0f;
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
@@ -402,7 +420,8 @@ void b2World::Solve(const b2TimeStep& step)
 					m_contactManager.m_contactCount,
 					m_jointCount,
 					&m_stackAllocator,
-					m_contactManager.m_contactListener);
+					m_contactManager.m_contactListener,
+					m_contactManager.m_contactEvents);
 
 	// Clear all the island flags.
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
@@ -584,7 +603,10 @@ void b2World::Solve(const b2TimeStep& step)
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
-	b2Island island(2 * b2_maxTOIContacts, b2_maxTOIContacts, 0, &m_stackAllocator, m_contactManager.m_contactListener);
+	b2_zone("b2World::SolveTOI");
+
+	b2Island island(2 * b2_maxTOIContacts, b2_maxTOIContacts, 0, &m_stackAllocator,
+					m_contactManager.m_contactListener, m_contactManager.m_contactEvents);
 
 	if (m_stepComplete)
 	{
@@ -740,7 +762,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		bB->Advance(minAlpha);
 
 		// The TOI contact likely has some new contact points.
-		minContact->Update(m_contactManager.m_contactListener);
+		minContact->Update(m_contactManager.m_contactListener, m_contactManager.m_contactEvents);
 		minContact->m_flags &= ~b2Contact::e_toiFlag;
 		++minContact->m_toiCount;
 
@@ -820,7 +842,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 					}
 
 					// Update the contact points
-					contact->Update(m_contactManager.m_contactListener);
+					contact->Update(m_contactManager.m_contactListener, m_contactManager.m_contactEvents);
 
 					// Was the contact disabled by the user?
 					if (contact->IsEnabled() == false)
@@ -904,6 +926,8 @@ void b2World::SolveTOI(const b2TimeStep& step)
 
 void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 {
+	b2_zone("b2World::Step");
+
 	b2Timer stepTimer;
 
 	// If new fixtures were added, we need to find the new contacts.
@@ -915,6 +939,12 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 
 	m_locked = true;
 
+	b2ContactEvents* events = m_contactManager.m_contactEvents;
+	if (events)
+	{
+		events->BeginStep();
+	}
+
 	b2TimeStep step;
 	step.dt = dt;
 	step.velocityIterations	= velocityIterations;
@@ -965,11 +995,307 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 		ClearForces();
 	}
 
+	if (events)
+	{
+		events->EndStep();
+	}
+
 	m_locked = false;
 
+	// Grow the stack now, while it is empty, once a step used more than 3/4 of it.
+	if (m_growStack)
+	{
+		int32 capacity = m_stackAllocator.GetCapacity();
+		int32 maxAllocation = m_stackAllocator.GetMaxAllocation();
+		if (4 * maxAllocation > 3 * capacity)
+		{
+			m_stackAllocator.Reserve(b2Max(2 * capacity, 2 * maxAllocation));
+		}
+	}
+
 	m_profile.step = stepTimer.GetMilliseconds();
 }
 
+void b2World::GetMemoryStats(b2BlockAllocatorStats* stats) const
+{
+	m_blockAllocator.GetStats(stats);
+}
+
+// Snapshot layout: header, bodies, fixture proxy AABBs, contacts (world list
+// order), broad-phase. Every section is padded to 8 bytes.
+struct b2WorldStateHeader
+{
+	uint32 magic;
+	int32 size;
+	const b2World* world;
+	const b2Body* bodyList;
+	int32 bodyCount;
+	int32 proxyCount;
+	int32 contactCount;
+	float inv_dt0;
+	bool newContacts;
+	bool stepComplete;
+};
+
+struct b2BodyState
+{
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	float angularVelocity;
+	b2Vec2 force;
+	float torque;
+	float sleepTime;
+	uint16 flags;
+};
+
+struct b2ContactState
+{
+	b2Fixture* fixtureA;
+	b2Fixture* fixtureB;
+	int32 indexA;
+	int32 indexB;
+	uint32 flags;
+	int32 toiCount;
+	float toi;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	float tangentSpeed;
+	b2Manifold manifold;
+};
+
+static const uint32 b2_worldStateMagic = 0x62325753; // "b2WS"
+
+static inline int32 b2StateSection(int32 count, int32 elementSize)
+{
+	return (count * elementSize + 7) & ~7;
+}
+
+int32 b2World::CountFixtureProxies() const
+{
+	int32 count = 0;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			count += f->m_proxyCount;
+		}
+	}
+	return count;
+}
+
+int32 b2World::GetStateSize() const
+{
+	return b2StateSection(1, sizeof(b2WorldStateHeader)) +
+		b2StateSection(m_bodyCount, sizeof(b2BodyState)) +
+		b2StateSection(CountFixtureProxies(), sizeof(b2AABB)) +
+		b2StateSection(m_contactManager.m_contactCount, sizeof(b2ContactState)) +
+		m_contactManager.m_broadPhase.GetStateSize();
+}
+
+int32 b2World::SaveState(void* buffer, int32 capacity) const
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked() || m_jointCount > 0)
+	{
+		return 0;
+	}
+
+	int32 size = GetStateSize();
+	if (size > capacity)
+	{
+		return 0;
+	}
+
+	uint8* p = (uint8*)buffer;
+	b2WorldStateHeader* header = (b2WorldStateHeader*)p;
+	header->magic = b2_worldStateMagic;
+	header->size = size;
+	header->world = this;
+	header->bodyList = m_bodyList;
+	header->bodyCount = m_bodyCount;
+	header->proxyCount = CountFixtureProxies();
+	header->contactCount = m_contactManager.m_contactCount;
+	header->inv_dt0 = m_inv_dt0;
+	header->newContacts = m_newContacts;
+	header->stepComplete = m_stepComplete;
+	p += b2StateSection(1, sizeof(b2WorldStateHeader));
+
+	b2BodyState* bodies = (b2BodyState*)p;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		bodies->xf = b->m_xf;
+		bodies->sweep = b->m_sweep;
+		bodies->linearVelocity = b->m_linearVelocity;
+		bodies->angularVelocity = b->m_angularVelocity;
+		bodies->force = b->m_force;
+		bodies->torque = b->m_torque;
+		bodies->sleepTime = b->m_sleepTime;
+		bodies->flags = b->m_flags;
+		++bodies;
+	}
+	p += b2StateSection(m_bodyCount, sizeof(b2BodyState));
+
+	b2AABB* aabbs = (b2AABB*)p;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				*aabbs++ = f->m_proxies[i].aabb;
+			}
+		}
+	}
+	p += b2StateSection(header->proxyCount, sizeof(b2AABB));
+
+	b2ContactState* contacts = (b2ContactState*)p;
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		contacts->fixtureA = c->m_fixtureA;
+		contacts->fixtureB = c->m_fixtureB;
+		contacts->indexA = c->m_indexA;
+		contacts->indexB = c->m_indexB;
+		contacts->flags = c->m_flags;
+		contacts->toiCount = c->m_toiCount;
+		contacts->toi = c->m_toi;
+		contacts->friction = c->m_friction;
+		contacts->restitution = c->m_restitution;
+		contacts->restitutionThreshold = c->m_restitutionThreshold;
+		contacts->tangentSpeed = c->m_tangentSpeed;
+		contacts->manifold = c->m_manifold;
+		++contacts;
+	}
+	p += b2StateSection(m_contactManager.m_contactCount, sizeof(b2ContactState));
+
+	m_contactManager.m_broadPhase.SaveState(p);
+
+	return size;
+}
+
+bool b2World::RestoreState(const void* buffer, int32 size)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked() || size < int32(sizeof(b2WorldStateHeader)))
+	{
+		return false;
+	}
+
+	const uint8* p = (const uint8*)buffer;
+	const b2WorldStateHeader* header = (const b2WorldStateHeader*)p;
+	if (header->magic != b2_worldStateMagic || header->size != size || header->world != this ||
+		header->bodyList != m_bodyList || header->bodyCount != m_bodyCount ||
+		header->proxyCount != CountFixtureProxies())
+	{
+		return false;
+	}
+	p += b2StateSection(1, sizeof(b2WorldStateHeader));
+
+	// Drop the current contacts without reporting them. Destroying a touching
+	// contact wakes its bodies, but the body flags are overwritten below.
+	b2ContactManager& cm = m_contactManager;
+	b2Contact* c = cm.m_contactList;
+	while (c)
+	{
+		b2Contact* next = c->m_next;
+		b2Contact::Destroy(c, &m_blockAllocator);
+		c = next;
+	}
+	cm.m_contactList = nullptr;
+	cm.m_contactCount = 0;
+
+	const b2BodyState* bodies = (const b2BodyState*)p;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_xf = bodies->xf;
+		b->m_sweep = bodies->sweep;
+		b->m_linearVelocity = bodies->linearVelocity;
+		b->m_angularVelocity = bodies->angularVelocity;
+		b->m_force = bodies->force;
+		b->m_torque = bodies->torque;
+		b->m_sleepTime = bodies->sleepTime;
+		b->m_flags = bodies->flags;
+		b->m_contactList = nullptr;
+		++bodies;
+	}
+	p += b2StateSection(m_bodyCount, sizeof(b2BodyState));
+
+	const b2AABB* aabbs = (const b2AABB*)p;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				f->m_proxies[i].aabb = *aabbs++;
+			}
+		}
+	}
+	p += b2StateSection(header->proxyCount, sizeof(b2AABB));
+
+	// Contacts are prepended to the world and body lists when created, so
+	// re-creating them oldest first rebuilds every list in its saved order.
+	// The solver walks those lists, so the order matters for determinism.
+	const b2ContactState* contacts = (const b2ContactState*)p;
+	for (int32 i = header->contactCount - 1; i >= 0; --i)
+	{
+		const b2ContactState& state = contacts[i];
+		c = b2Contact::Create(state.fixtureA, state.indexA, state.fixtureB, state.indexB, &m_blockAllocator);
+		b2Assert(c && c->m_fixtureA == state.fixtureA);
+
+		c->m_flags = state.flags;
+		c->m_toiCount = state.toiCount;
+		c->m_toi = state.toi;
+		c->m_friction = state.friction;
+		c->m_restitution = state.restitution;
+		c->m_restitutionThreshold = state.restitutionThreshold;
+		c->m_tangentSpeed = state.tangentSpeed;
+		c->m_manifold = state.manifold;
+
+		b2Body* bodyA = state.fixtureA->m_body;
+		b2Body* bodyB = state.fixtureB->m_body;
+
+		c->m_prev = nullptr;
+		c->m_next = cm.m_contactList;
+		if (cm.m_contactList != nullptr)
+		{
+			cm.m_contactList->m_prev = c;
+		}
+		cm.m_contactList = c;
+
+		c->m_nodeA.contact = c;
+		c->m_nodeA.other = bodyB;
+		c->m_nodeA.prev = nullptr;
+		c->m_nodeA.next = bodyA->m_contactList;
+		if (bodyA->m_contactList != nullptr)
+		{
+			bodyA->m_contactList->prev = &c->m_nodeA;
+		}
+		bodyA->m_contactList = &c->m_nodeA;
+
+		c->m_nodeB.contact = c;
+		c->m_nodeB.other = bodyA;
+		c->m_nodeB.prev = nullptr;
+		c->m_nodeB.next = bodyB->m_contactList;
+		if (bodyB->m_contactList != nullptr)
+		{
+			bodyB->m_contactList->prev = &c->m_nodeB;
+		}
+		bodyB->m_contactList = &c->m_nodeB;
+
+		++cm.m_contactCount;
+	}
+	p += b2StateSection(header->contactCount, sizeof(b2ContactState));
+
+	cm.m_broadPhase.RestoreState(p);
+
+	m_inv_dt0 = header->inv_dt0;
+	m_newContacts = header->newContacts;
+	m_stepComplete = header->stepComplete;
+	return true;
+}
+
 void b2World::ClearForces()
 {
 	for (b2Body* body = m_bodyList; body; body = body->GetNext())
@@ -979,6 +1305,78 @@ void b2World::ClearForces()
 	}
 }
 
+// FNV-1a over 32-bit words: the inputs are already well mixed float bits
+static const uint64 b2_hashOffset = 0xcbf29ce484222325ULL;
+static const uint64 b2_hashPrime = 0x100000001b3ULL;
+
+static inline void b2HashWord(uint64& hash, uint32 word)
+{
+	hash = (hash ^ word) * b2_hashPrime;
+}
+
+static inline void b2HashFloat(uint64& hash, float value)
+{
+	uint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	b2HashWord(hash, bits);
+}
+
+static inline void b2HashVec2(uint64& hash, const b2Vec2& v)
+{
+	b2HashFloat(hash, v.x);
+	b2HashFloat(hash, v.y);
+}
+
+void b2World::GetStateHash(b2WorldHash* hash) const
+{
+	uint64 transforms = b2_hashOffset;
+	uint64 velocities = b2_hashOffset;
+	uint64 contacts = b2_hashOffset;
+	uint64 sleep = b2_hashOffset;
+
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		if (b->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
+		b2HashVec2(transforms, b->m_xf.p);
+		b2HashFloat(transforms, b->m_xf.q.s);
+		b2HashFloat(transforms, b->m_xf.q.c);
+		b2HashVec2(transforms, b->m_sweep.c0);
+		b2HashVec2(transforms, b->m_sweep.c);
+		b2HashFloat(transforms, b->m_sweep.a0);
+		b2HashFloat(transforms, b->m_sweep.a);
+		b2HashFloat(transforms, b->m_sweep.alpha0);
+
+		b2HashVec2(velocities, b->m_linearVelocity);
+		b2HashFloat(velocities, b->m_angularVelocity);
+
+		b2HashFloat(sleep, b->m_sleepTime);
+		b2HashWord(sleep, (b->m_flags & b2Body::e_awakeFlag) ? 1 : 0);
+	}
+
+	for (const b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		b2HashWord(contacts, c->m_flags & (b2Contact::e_touchingFlag | b2Contact::e_enabledFlag));
+		const b2Manifold& m = c->m_manifold;
+		b2HashWord(contacts, uint32(m.pointCount));
+		for (int32 i = 0; i < m.pointCount; ++i)
+		{
+			b2HashVec2(contacts, m.points[i].localPoint);
+			b2HashFloat(contacts, m.points[i].normalImpulse);
+			b2HashFloat(contacts, m.points[i].tangentImpulse);
+			b2HashWord(contacts, m.points[i].id.key);
+		}
+	}
+
+	hash->transforms = transforms;
+	hash->velocities = velocities;
+	hash->contacts = contacts;
+	hash->sleep = sleep;
+}
+
 struct b2WorldQueryWrapper
 {
 	bool QueryCallback(int32 proxyId)
@@ -0,0 +1,118 @@
+#include "Difficulty.h"
+#include "PhysicsEngine.h"
+#include "TiltBot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// Fraction of finishing rollouts that par is set to beat
+static const float PAR_QUANTILE = 0.75f;
+
+// splitmix64: a noise seed per rollout from the run's seed alone
+static uint32_t rolloutSeed(uint64_t seed, int levelId, int rollout) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (static_cast<uint64_t>(levelId) * 0x10001ull + rollout + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+}
+
+Difficulty::Result Difficulty::estimate(const LevelView &view, const Options &options) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Result result = Result();
+    result.levelId = view.id;
+    LevelConfig level;
+    LevelData::assign(level, view);
+
+    int count = std::max(0, options.rollouts);
+    result.rollouts.resize(count);
+    for (int r = 0; r < count; ++r) {
+        Rollout &rollout = result.rollouts[r];
+        // Evenly from minNoise to maxNoise, so the mix of hands is the same
+        // for any rollout count
+        rollout.noise = count > 1 ? options.minNoise + (options.maxNoise - options.minNoise) * r / (count - 1)
+                                  : options.minNoise;
+        rollout.ticks = -1;
+        rollout.respawns = 0;
+    }
+
+    result.hasPath = TiltBot(level).hasPath();
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, std::max(1, count)));
+    result.threads = threads;
+    if (!result.hasPath || count == 0) {
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    // Workers claim rollouts by index and write only their own slots
+    std::atomic<int> next(0);
+    std::atomic<uint64_t> ticks(0);
+    int limit = static_cast<int>(options.limitSeconds * options.tickRate);
+    auto worker = [&]() {
+        PhysicsEngine physics(false);
+        physics.setTickRate(options.tickRate);
+        physics.loadLevel(view);
+        TiltBot bot(level);
+        uint64_t local = 0;
+        for (int r = next.fetch_add(1); r < count; r = next.fetch_add(1)) {
+            Rollout &rollout = result.rollouts[r];
+            physics.reset();
+            uint32_t respawns = physics.getRespawnCount();
+            bot.setNoise(rolloutSeed(options.seed, view.id, r), rollout.noise);
+            rollout.ticks = bot.play(physics, limit);
+            rollout.respawns = physics.getRespawnCount() - respawns;
+            local += rollout.ticks > 0 ? rollout.ticks : limit;
+        }
+        ticks += local;
+    };
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::thread &t : pool)
+        t.join();
+    result.ticks = ticks.load();
+
+    std::vector<int> finishes;
+    int clean = 0;
+    for (const Rollout &rollout : result.rollouts) {
+        if (rollout.ticks < 0)
+            continue;
+        finishes.push_back(rollout.ticks);
+        clean += rollout.respawns == 0;
+    }
+    result.rating.successRate = static_cast<float>(clean) / count;
+    if (!finishes.empty()) {
+        std::sort(finishes.begin(), finishes.end());
+        size_t n = finishes.size();
+        float median = n % 2 ? finishes[n / 2] : 0.5f * (finishes[n / 2 - 1] + finishes[n / 2]);
+        int quantile = finishes[std::min(n - 1, static_cast<size_t>(std::ceil(PAR_QUANTILE * n)) - 1)];
+        result.rating.medianSeconds = median / options.tickRate;
+        result.rating.parSeconds = std::ceil(static_cast<float>(quantile) / options.tickRate);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void Difficulty::report(std::ostream &out, const Result &result) {
+    if (!result.hasPath) {
+        out << "level " << result.levelId << ": no way to the hole, not rated" << std::endl;
+        return;
+    }
+    int finished = 0;
+    uint64_t water = 0;
+    for (const Rollout &rollout : result.rollouts) {
+        finished += rollout.ticks >= 0;
+        water += rollout.respawns;
+    }
+    int count = static_cast<int>(result.rollouts.size());
+    double rate = result.seconds > 0.0 ? result.ticks / result.seconds : 0.0;
+    out << "level " << result.levelId << ": par " << result.rating.parSeconds << " s, success "
+        << 100.0f * result.rating.successRate << "%, median " << result.rating.medianSeconds << " s; " << finished
+        << "/" << count << " in the hole, " << water << " water hits; " << result.seconds << " s on "
+        << result.threads << (result.threads == 1 ? " thread" : " threads") << " (" << rate / 1000.0
+        << "k ticks/s)" << std::endl;
+}
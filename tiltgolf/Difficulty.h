@@ -0,0 +1,56 @@
+#ifndef DIFFICULTY_H
+#define DIFFICULTY_H
+
+#include <stdint.h>
+#include <ostream>
+#include <vector>
+
+#include "LevelData.h"
+
+// How hard a level is, by Monte Carlo: many TiltBot games with random tilt
+// error stand in for players of varying skill.
+//
+// Each rollout plays the level from the start with its own noise, drawn from
+// the seed and the rollout number alone, until the ball is in the hole or
+// the time limit runs out. A rollout succeeds when it gets there without
+// falling in the water. From all rollouts come the success rate, the median
+// time to the hole (of those that got there, water or not) and par: the
+// time three quarters of them beat, rounded up to a whole second. Rollouts
+// run on all cores and the result does not depend on the thread count.
+class Difficulty {
+public:
+    struct Options {
+        int rollouts = 64;
+        // Tilt error per axis, spread evenly over the rollouts from steady
+        // to shaky hands. It is drawn anew every tick and the input filter
+        // smooths most of it out, hence the large top end.
+        int minNoise = 0;
+        int maxNoise = 400;
+        float limitSeconds = 180.0f; // a rollout not in by then fails
+        int tickRate = 60;
+        int threads = 0;             // 0: one per core
+        uint64_t seed = 1;
+    };
+
+    struct Rollout {
+        int noise;          // counts per axis
+        int ticks;          // to the hole, -1 if not in within the limit
+        uint32_t respawns;  // water hits on the way
+    };
+
+    struct Result {
+        int levelId;
+        bool hasPath;       // false: the bot finds no way, nothing was played
+        LevelRating rating;
+        std::vector<Rollout> rollouts;
+        uint64_t ticks;     // simulated over all rollouts
+        int threads;
+        double seconds;
+    };
+
+    static Result estimate(const LevelView &level, const Options &options);
+    // One line: rating, finishes, water hits and speed
+    static void report(std::ostream &out, const Result &result);
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "FlowField.h"
+#include "GridSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// vector::assign takes them by reference
+constexpr float FlowField::CELL;
+constexpr float FlowField::UNIT;
+const uint16_t FlowField::NONE;
+
+static bool inside(const b2Vec2 &p, const b2Vec2 &centre, const b2Vec2 &half) {
+    return std::fabs(p.x - centre.x) < half.x && std::fabs(p.y - centre.y) < half.y;
+}
+
+FlowField::FlowField() : level(0), cols(0), rows(0), buildTime(0), done(false), requested(0) {}
+
+FlowField::~FlowField() {
+    wait();
+}
+
+void FlowField::buildAsync(const LevelConfig &config) {
+    int ticket;
+    {
+        std::lock_guard<std::mutex> lock(publish);
+        ticket = ++requested;
+        done.store(false);
+    }
+    worker.post([this, config, ticket]() {
+        {
+            std::lock_guard<std::mutex> lock(publish);
+            if (ticket != requested)
+                return;
+        }
+        compute(config);
+        std::lock_guard<std::mutex> lock(publish);
+        if (ticket == requested)
+            done.store(true, std::memory_order_release);
+    });
+}
+
+void FlowField::wait() {
+    worker.wait();
+}
+
+void FlowField::build(const LevelConfig &config) {
+    done.store(false);
+    compute(config);
+    done.store(true, std::memory_order_release);
+}
+
+void FlowField::compute(const LevelConfig &config) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    level = config.id;
+    cols = std::max(1, static_cast<int>(std::ceil(config.width / CELL)));
+    rows = std::max(1, static_cast<int>(std::ceil(config.height / CELL)));
+
+    // A cell is free if the ball's centre can be somewhere in it: ball-wide
+    // lanes and starts against a wall fall between cell centres
+    const float half = 0.5f * CELL;
+    const float reach = BALL_RADIUS - half;
+    std::vector<char> passable(cols * rows, 0);
+    std::vector<char> safe(cols * rows, 0);
+    for (int cell = 0; cell < cols * rows; ++cell) {
+        b2Vec2 p((cell % cols + 0.5f) * CELL, (cell / cols + 0.5f) * CELL);
+        bool ok = p.x >= reach && p.x <= config.width - reach && p.y >= reach && p.y <= config.height - reach;
+        for (const WallDef &w : config.walls) {
+            if (!ok) break;
+            ok = GridSearch::boxDistance(p, w.position, w.size) >= reach;
+        }
+        for (const WallDef &w : config.water) {
+            if (!ok) break;
+            ok = !inside(p, w.position, w.size - b2Vec2(half, half));
+        }
+        passable[cell] = ok;
+
+        // Conservative bound: wherever a block can be during its sweep
+        for (const MovingWaterDef &m : config.movingWater) {
+            if (!ok) break;
+            ok = !inside(p, m.basePosition, b2Vec2(m.size.x - half, m.size.y + std::fabs(m.amplitude) - half));
+        }
+        safe[cell] = ok;
+    }
+
+    fill(staticLayer, passable, config.holePos);
+    fill(safeLayer, safe, config.holePos);
+    buildTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void FlowField::fill(std::vector<uint16_t> &layer, const std::vector<char> &passable, const b2Vec2 &hole) {
+    std::vector<float> dist;
+    GridSearch::toHole(cols, rows, CELL, passable, hole, nullptr, dist);
+
+    // The vector keeps its storage from the last level
+    layer.assign(cols * rows, NONE);
+    for (int cell = 0; cell < cols * rows; ++cell) {
+        if (dist[cell] >= 0.0f)
+            layer[cell] = static_cast<uint16_t>(std::min(65534.0f, std::round(dist[cell] / UNIT)));
+    }
+}
+
+int FlowField::cellAt(const b2Vec2 &p) const {
+    int c = static_cast<int>(std::floor(p.x / CELL));
+    int r = static_cast<int>(std::floor(p.y / CELL));
+    if (c < 0 || c >= cols || r < 0 || r >= rows) return -1;
+    return r * cols + c;
+}
+
+float FlowField::lookup(const std::vector<uint16_t> &layer, const b2Vec2 &p) const {
+    if (!ready()) return -1.0f;
+    int cell = cellAt(p);
+    if (cell < 0 || layer[cell] == NONE) return -1.0f;
+    return layer[cell] * UNIT;
+}
+
+b2Vec2 FlowField::direction(const b2Vec2 &p) const {
+    if (!ready()) return b2Vec2(0.0f, 0.0f);
+    int cell = cellAt(p);
+    if (cell < 0) return b2Vec2(0.0f, 0.0f);
+    const std::vector<uint16_t> &layer = safeLayer[cell] != NONE ? safeLayer : staticLayer;
+    if (layer[cell] == NONE) return b2Vec2(0.0f, 0.0f);
+
+    int c = cell % cols, r = cell / cols;
+    int best = -1;
+    uint16_t bestValue = layer[cell];
+    for (int k = 0; k < 8; ++k) {
+        int nc = c + GridSearch::DC[k], nr = r + GridSearch::DR[k];
+        if (nc < 0 || nc >= cols || nr < 0 || nr >= rows) continue;
+        int n = nr * cols + nc;
+        if (layer[n] >= bestValue) continue;
+        if (k >= 4 && (layer[r * cols + nc] == NONE || layer[nr * cols + c] == NONE)) continue;
+        best = k;
+        bestValue = layer[n];
+    }
+    if (best < 0) return b2Vec2(0.0f, 0.0f);
+    b2Vec2 d(static_cast<float>(GridSearch::DC[best]), static_cast<float>(GridSearch::DR[best]));
+    d.Normalize();
+    return d;
+}
@@ -0,0 +1,87 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "box2d/box2d.h"
+#include "BackgroundWorker.h"
+#include "LevelData.h"
+
+// Distance to the hole through walkable space, precomputed once per level for
+// hint arrows, bots and difficulty estimates.
+//
+// The level is cut into CELL-sized cells. A cell is blocked when the ball's
+// centre cannot be anywhere in it (walls grown by the ball radius) or only
+// where the engine would take it (inside still water; water is not grown, the
+// engine only checks the centre). The same search from the hole as the bot's
+// (GridSearch.h), unweighted, gives each cell its distance, stored as a
+// 16-bit count of UNIT. Lookups are one array read.
+//
+// Moving water is handled with conservative bounds: a second layer also
+// blocks every cell the blocks can reach anywhere along their sweep. Where
+// that layer has a distance, following it can never meet moving water; where
+// it has none (level 3 has no way round its sweeps), only the first layer
+// helps and the timing is up to the player.
+//
+// buildAsync() computes the field on the field's background worker (see
+// BackgroundWorker.h); until it is done (ready()) lookups report no distance.
+// A newer buildAsync() supersedes a build still queued or running. Call it
+// and the lookups from the same thread.
+class FlowField {
+public:
+    static constexpr float CELL = 0.125f;       // metres
+    static constexpr float UNIT = 1.0f / 256.0f; // metres per stored count (up to 256 m)
+    static const uint16_t NONE = 0xFFFF;        // blocked or cut off from the hole
+
+    FlowField();
+    // Waits for a background build
+    ~FlowField();
+
+    // Compute the field for this level now
+    void build(const LevelConfig &level);
+    // Compute it on the background worker (the level is copied)
+    void buildAsync(const LevelConfig &level);
+    bool ready() const { return done.load(std::memory_order_acquire); }
+    void wait();
+
+    // Metres to the hole from p, ignoring moving water; < 0 if there is no
+    // way, p is blocked or the field is not ready
+    float distance(const b2Vec2 &p) const { return lookup(staticLayer, p); }
+    // The same, never entering anywhere moving water can be
+    float safeDistance(const b2Vec2 &p) const { return lookup(safeLayer, p); }
+    // Unit vector from p towards the neighbouring cell closest to the hole,
+    // on the safe layer where it has a distance; zero if none
+    b2Vec2 direction(const b2Vec2 &p) const;
+
+    int levelId() const { return level; }
+    int columns() const { return cols; }
+    int rowCount() const { return rows; }
+    size_t bytes() const { return (staticLayer.size() + safeLayer.size()) * sizeof(uint16_t); }
+    int64_t buildNs() const { return buildTime; }
+
+private:
+    FlowField(const FlowField &);
+    FlowField &operator=(const FlowField &);
+
+    int cellAt(const b2Vec2 &p) const;
+    float lookup(const std::vector<uint16_t> &layer, const b2Vec2 &p) const;
+    void compute(const LevelConfig &level);
+    void fill(std::vector<uint16_t> &layer, const std::vector<char> &passable, const b2Vec2 &hole);
+
+    int level;
+    int cols, rows;
+    std::vector<uint16_t> staticLayer;
+    std::vector<uint16_t> safeLayer;
+    int64_t buildTime;
+    std::atomic<bool> done;
+    // Latest buildAsync(); only its build may set done
+    std::mutex publish;
+    int requested;
+    // Last member: destroyed first, so no build runs on a dying field
+    BackgroundWorker worker;
+};
+
+#endif
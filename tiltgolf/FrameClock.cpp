@@ -0,0 +1,138 @@
+#include "FrameClock.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+static const int64_t NS_PER_S = 1000000000;
+
+static int64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NS_PER_S + ts.tv_nsec;
+}
+
+static timespec toTimespec(int64_t ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / NS_PER_S);
+    ts.tv_nsec = static_cast<long>(ns % NS_PER_S);
+    return ts;
+}
+
+FrameClock::FrameClock() : running(false), period(0), startNs(0), expired(0) {
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0)
+        std::cerr << "FrameClock: timerfd_create failed: " << std::strerror(errno) << std::endl;
+    resetStats();
+}
+
+FrameClock::~FrameClock() {
+    if (timerFd >= 0)
+        close(timerFd);
+}
+
+bool FrameClock::start(int64_t periodNs) {
+    if (timerFd < 0 || periodNs <= 0)
+        return false;
+
+    period = periodNs;
+    startNs = monotonicNs();
+    expired = 0;
+
+    // Absolute deadlines: the kernel keeps start + n * period exact
+    itimerspec spec;
+    spec.it_value = toTimespec(startNs + period);
+    spec.it_interval = toTimespec(period);
+    if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+        std::cerr << "FrameClock: timerfd_settime failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+bool FrameClock::start() {
+    return period > 0 && start(period);
+}
+
+void FrameClock::stop() {
+    if (timerFd < 0 || !running)
+        return;
+    itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+    running = false;
+}
+
+uint64_t FrameClock::acknowledge() {
+    return consume(false);
+}
+
+uint64_t FrameClock::wait() {
+    return consume(true);
+}
+
+uint64_t FrameClock::consume(bool block) {
+    if (!running)
+        return 0;
+
+    uint64_t count = 0;
+    for (;;) {
+        if (read(timerFd, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count)))
+            break;
+        if (errno == EINTR)
+            continue;
+        if (errno != EAGAIN || !block)
+            return 0;
+        // Non-blocking fd: sleep until the next deadline, then read again
+        int64_t next = startNs + static_cast<int64_t>(expired + 1) * period;
+        timespec until = toTimespec(next);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr);
+    }
+
+    // Lateness of the newest deadline that passed
+    expired += count;
+    int64_t late = monotonicNs() - (startNs + static_cast<int64_t>(expired) * period);
+    if (late < 0)
+        late = 0;
+
+    counters.ticks++;
+    counters.missed += count - 1;
+    counters.totalLateNs += late;
+    if (late > counters.maxLateNs)
+        counters.maxLateNs = late;
+    int bucket = 0;
+    while (bucket < HISTOGRAM_BUCKETS - 1 && late >= (FIRST_BUCKET_NS << bucket))
+        bucket++;
+    counters.histogram[bucket]++;
+    return count;
+}
+
+void FrameClock::resetStats() {
+    std::memset(&counters, 0, sizeof(counters));
+}
+
+int64_t FrameClock::latePercentileNs(double fraction) const {
+    if (counters.ticks == 0)
+        return 0;
+    uint64_t wanted = static_cast<uint64_t>(std::ceil(fraction * counters.ticks));
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS - 1; ++i) {
+        seen += counters.histogram[i];
+        if (seen >= wanted)
+            return FIRST_BUCKET_NS << i;
+    }
+    return counters.maxLateNs;
+}
+
+void FrameClock::report(std::ostream &out, const char *name) const {
+    double meanUs = counters.ticks ? counters.totalLateNs / 1000.0 / counters.ticks : 0.0;
+    out << name << ": " << counters.ticks << " ticks, " << counters.missed << " missed deadlines, late mean "
+        << meanUs << " us, p99 < " << latePercentileNs(0.99) / 1000 << " us, p99.9 < "
+        << latePercentileNs(0.999) / 1000 << " us, max " << counters.maxLateNs / 1000 << " us" << std::endl;
+}
@@ -0,0 +1,74 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <stdint.h>
+#include <ostream>
+
+// Periodic tick source on a timerfd with absolute CLOCK_MONOTONIC deadlines.
+//
+// Deadlines are start + n * period, so late ticks do not shift the ones after
+// them the way a restarted QTimer does. The fd becomes readable at each
+// deadline; the game loop watches it with a QSocketNotifier and calls
+// acknowledge(), a thread without an event loop can block in wait().
+//
+// Every acknowledged tick records how late it was read and how many
+// deadlines passed unseen, for production monitoring.
+class FrameClock {
+public:
+    // Lateness histogram: bucket 0 is under 64 us, bucket i under 64 us << i,
+    // the last one everything beyond
+    static const int HISTOGRAM_BUCKETS = 10;
+    static const int64_t FIRST_BUCKET_NS = 64 * 1000;
+
+    struct Stats {
+        uint64_t ticks;      // deadlines handled (one call each)
+        uint64_t missed;     // deadlines that passed while an earlier one was pending
+        int64_t maxLateNs;
+        int64_t totalLateNs;
+        uint64_t histogram[HISTOGRAM_BUCKETS];
+    };
+
+    FrameClock();
+    ~FrameClock();
+
+    // Start ticking every periodNs; the first deadline is one period from now.
+    // Restarting resets the phase but keeps the statistics.
+    bool start(int64_t periodNs);
+    // Start again with the last period (e.g. after a pause)
+    bool start();
+    void stop();
+    bool isRunning() const { return running; }
+    int64_t periodNs() const { return period; }
+
+    // Readable when a deadline has passed; -1 if the timerfd could not be created
+    int fd() const { return timerFd; }
+
+    // Consume the expired deadlines without blocking. Returns how many passed
+    // since the last call (0 if none; more than 1 means missed ticks).
+    uint64_t acknowledge();
+    // Block until the next deadline, then as acknowledge()
+    uint64_t wait();
+
+    const Stats &stats() const { return counters; }
+    void resetStats();
+    // Lateness below which `fraction` of the ticks fall, from the histogram
+    // (upper bucket bound; the maximum for the last bucket)
+    int64_t latePercentileNs(double fraction) const;
+    // One-line summary: ticks, missed, mean/p99/p99.9/max lateness
+    void report(std::ostream &out, const char *name) const;
+
+private:
+    FrameClock(const FrameClock &);
+    FrameClock &operator=(const FrameClock &);
+
+    uint64_t consume(bool block);
+
+    int timerFd;
+    bool running;
+    int64_t period;
+    int64_t startNs;      // CLOCK_MONOTONIC time of deadline 0
+    uint64_t expired;     // deadlines since start
+    Stats counters;
+};
+
+#endif
@@ -1,64 +1,173 @@
 #include "GameController.h"
+#include "Profiler.h"
 
 #include <iostream>
+#include <cstdlib>
+#include <vector>
 
-GameController::GameController(QObject *parent) : QObject(parent), isWon(false) {
+GameController::GameController(QObject *parent)
+    : QObject(parent), isWon(false), isRewinding(false), showHints(false), showPrediction(false),
+      levelCache(CACHED_LEVELS) {
     physics = new PhysicsEngine();
+    physics->setRewindBuffer(&history);
+    // Less CPU on the board when the ball is slow or still
+    if (std::getenv("TILTGOLF_ADAPTIVE_STEP"))
+        physics->setAdaptiveStepping(true);
+    // e.g. 30 on a loaded board; hazards are swept so the ball cannot skip water
+    if (const char *tickRate = std::getenv("TILTGOLF_TICK_RATE"))
+        physics->setTickRate(std::atoi(tickRate));
+
+    // Levels from a compiled pack (tools/levelc) without reflashing the game
+    const char *levelsPath = std::getenv("TILTGOLF_LEVELS");
+    if (levelsPath && levelPack.open(levelsPath))
+        std::cout << "GameController: " << levelPack.count() << " levels from " << levelsPath << std::endl;
+
+    // Build the first levels in the background while the menus are up; the
+    // rest are built ahead of the player in loadLevel()
+    std::vector<LevelView> levels;
+    for (int id = 1; id <= LevelData::LEVEL_COUNT; ++id) {
+        LevelView level;
+        if (findLevel(id, level))
+            levels.push_back(level);
+    }
+    levelCache.prepare(levels);
+    physics->setLevelCache(&levelCache);
+
+    // Record every run for deterministic replay (tools/headless --replay <file>)
+    const char *recordPath = std::getenv("TILTGOLF_RECORD");
+    if (recordPath && recorder.open(recordPath)) {
+        physics->setRecorder(&recorder);
+        std::cout << "GameController: recording input to " << recordPath << std::endl;
+    }
+    const char *trajectoryPath = std::getenv("TILTGOLF_TRAJECTORY");
+    if (trajectoryPath && trajectory.open(trajectoryPath))
+        std::cout << "GameController: recording trajectory to " << trajectoryPath << std::endl;
+    // Arrow from the ball along the shortest way to the hole
+    showHints = std::getenv("TILTGOLF_HINTS") != nullptr;
+    // Dotted path of where the ball rolls if the tilt is held
+    showPrediction = std::getenv("TILTGOLF_PREDICT") != nullptr;
+
+    // trace_zones builds: `kill -USR1 <pid>` dumps a Chrome trace
+    Profiler::installDumpSignal("/tmp/tiltgolf-trace.json");
     
-    // Run game loop at ~60 FPS
-    gameTimer = new QTimer(this);
-    connect(gameTimer, &QTimer::timeout, this, &GameController::gameLoop);
+    // Run game loop at the physics tick rate (60 FPS by default)
+    frameNotifier = new QSocketNotifier(frameClock.fd(), QSocketNotifier::Read, this);
+    connect(frameNotifier, QOverload<QSocketDescriptor, QSocketNotifier::Type>::of(&QSocketNotifier::activated),
+            this, &GameController::onFrameClock);
 }
 
 GameController::~GameController() {
+    frameClock.report(std::cout, "GameController: frame clock");
+    levelCache.report(std::cout, "GameController: level cache");
+    if (showPrediction)
+        prediction.report(std::cout, "GameController: prediction");
+    // Hands the borrowed level world back to the cache
     delete physics;
 }
 
 void GameController::loadLevel(int levelId) {
-    currentLevel = LevelData::getLevel(levelId);
-    physics->loadLevel(currentLevel);
+    // Timing of the level just played, for monitoring on the board
+    if (frameClock.stats().ticks > 0) {
+        frameClock.report(std::cout, "GameController: frame clock");
+        frameClock.resetStats();
+    }
+    LevelView level;
+    if (!findLevel(levelId, level))
+        level = LevelData::builtin(levelId);
+    physics->loadLevel(level);
+
+    // Keep this level for a replay (a no-op if it came from the cache) and
+    // build the next while this one is played
+    std::vector<LevelView> ahead(1, level);
+    LevelView next;
+    if (findLevel(levelId + 1, next))
+        ahead.push_back(next);
+    levelCache.prepare(ahead);
+
+    // Only the hint arrow reads the field
+    if (showHints)
+        flowField.buildAsync(physics->getLevelConfig());
+    if (showPrediction)
+        prediction.update(*physics);
     isWon = false;
-    gameTimer->start(16); // ~60 FPS
+    if (!frameClock.start(1000000000LL / physics->getTickRate()))
+        std::cerr << "GameController: frame clock failed to start" << std::endl;
+}
+
+void GameController::onFrameClock() {
+    // More than one expiry means deadlines were missed; those ticks are
+    // dropped (counted in the clock's stats), not simulated late
+    if (frameClock.acknowledge() > 0)
+        gameLoop();
 }
 
 void GameController::resetGame() {
     physics->reset();
+    if (showPrediction)
+        prediction.update(*physics);
     isWon = false;
-    gameTimer->start();
+    frameClock.start();
     emit gameStateUpdated();
 }
 
 void GameController::pauseGame() {
-    gameTimer->stop();
+    frameClock.stop();
 }
 
 void GameController::resumeGame() {
-    if (!isWon) gameTimer->start();
+    if (!isWon) frameClock.start();
+}
+
+void GameController::startRewind() {
+    isRewinding = true;
+}
+
+void GameController::stopRewind() {
+    isRewinding = false;
 }
 
 void GameController::gameLoop() {
+    PROFILE_ZONE("GameController::gameLoop");
+    Profiler::pollDump();
     if (isWon) return;
 
-    // 1. Step Physics
-    physics->step();
-    // Pull latest level state (for moving water)
-    currentLevel = physics->getLevelConfig();
+    if (isRewinding) {
+        // Stops at the oldest tick the history still holds
+        physics->rewind(1);
+        if (showPrediction)
+            prediction.update(*physics);
+        emit gameStateUpdated();
+        return;
+    }
 
-    // 2. Check Win Condition
-    // Calculate distance between ball center and hole center
-    b2Vec2 ballPos = physics->getBallPosition();
-    b2Vec2 distVec = ballPos - currentLevel.holePos;
-    
-    // If distance is less than hole radius (ball center is inside hole)
-    // You can adjust tolerance (e.g. radius * 0.5) to make it harder
-    if (distVec.Length() < (currentLevel.holeRadius * 0.5f)) {
+    // 1. Step Physics. Ball asleep and nothing else moving: only watch the
+    //    tilt. No physics step and no repaint until it would move the ball;
+    //    the last frame drawn is still correct. The sample that wakes it is
+    //    the one stepped, so a waking tick reads the bus once.
+    if (physics->isAtRest()) {
+        if (!physics->pollTilt())
+            return;
+        physics->stepPolled();
+    } else {
+        physics->step();
+    }
+
+    // 2. Check Win Condition (ball center well inside the hole; the
+    //    tolerance is in PhysicsEngine::isBallInHole)
+    if (physics->isBallInHole()) {
         isWon = true;
-        gameTimer->stop();
+        frameClock.stop();
         emit gameWon();
         std::cout << "HOLE IN ONE!" << std::endl;
     }
+    trajectory.addFrame(*physics, isWon ? TRAJ_EVENT_HOLE : 0);
+
+    // 3. Where the ball goes from here if the tilt is held (after the
+    //    trajectory frame: the lookahead replaces the tick's contact events)
+    if (showPrediction && !isWon)
+        prediction.update(*physics);
 
-    // 3. Notify View
+    // 4. Notify View
     emit gameStateUpdated();
 }
 
@@ -66,8 +175,24 @@ b2Vec2 GameController::getBallPos() const {
     return physics->getBallPosition();
 }
 
-LevelConfig GameController::getCurrentLevel() const {
-    return currentLevel;
+const LevelConfig& GameController::getCurrentLevel() const {
+    return physics->getLevelConfig();
+}
+
+LevelRating GameController::getRating(int levelId) const {
+    LevelView level;
+    if (!findLevel(levelId, level))
+        level = LevelData::builtin(levelId);
+    return level.rating;
+}
+
+bool GameController::findLevel(int levelId, LevelView &level) const {
+    if (levelPack.find(levelId, level))
+        return true;
+    if (levelId < 1 || levelId > LevelData::LEVEL_COUNT)
+        return false;
+    level = LevelData::builtin(levelId);
+    return true;
 }
 
 void GameController::calibrateIMU()
@@ -2,9 +2,17 @@
 #define GAMECONTROLLER_H
 
 #include <QObject>
-#include <QTimer>
+#include <QSocketNotifier>
+#include "FlowField.h"
+#include "FrameClock.h"
+#include "LevelCache.h"
 #include "PhysicsEngine.h"
+#include "Prediction.h"
 #include "LevelData.h"
+#include "LevelPack.h"
+#include "Replay.h"
+#include "Rewind.h"
+#include "Trajectory.h"
 
 class GameController : public QObject {
     Q_OBJECT
@@ -17,13 +25,34 @@ public:
     
     // Getters for View
     b2Vec2 getBallPos() const;
-    LevelConfig getCurrentLevel() const;
+    const LevelConfig& getCurrentLevel() const;
+    // Par and difficulty of a level (from the pack if it replaces the
+    // built-in one); zero if it has not been rated
+    LevelRating getRating(int levelId) const;
+
+    // Game loop timing: missed deadlines and lateness histogram
+    const FrameClock& getFrameClock() const { return frameClock; }
+    // Level load times, cache hits and misses
+    const LevelCache& getLevelCache() const { return levelCache; }
+    // Distance to the hole for the current level; ready() a moment after
+    // loadLevel() while hints are enabled
+    const FlowField& getFlowField() const { return flowField; }
+    // Hint arrow towards the hole, enabled with TILTGOLF_HINTS
+    bool hintsEnabled() const { return showHints; }
+    // Ghost path under the held tilt, enabled with TILTGOLF_PREDICT
+    const Prediction& getPrediction() const { return prediction; }
+    bool predictionEnabled() const { return showPrediction; }
 
 public slots:
     void resetGame();
     void pauseGame();
     void resumeGame();
 
+    // While rewinding each frame steps the simulation back one tick instead
+    // of forward; play resumes from there on stopRewind()
+    void startRewind();
+    void stopRewind();
+
     // Expose simple IMU calibrate action to UI
     void calibrateIMU();
 
@@ -37,13 +66,47 @@ signals:
     void gameWon();          // Tells GameScreen we finished
 
 private slots:
+    void onFrameClock();
     void gameLoop();
 
 private:
+    // Level templates kept: the built-in levels, the one being played and
+    // the next (a pack may hold hundreds, at over 128 KB each)
+    static const int CACHED_LEVELS = LevelData::LEVEL_COUNT + 2;
+
+    // The pack's level with this id, else the built-in one; false if neither has it
+    bool findLevel(int levelId, LevelView &level) const;
+
     PhysicsEngine* physics;
-    QTimer* gameTimer;
-    LevelConfig currentLevel;
+    // One tick per physics step on absolute deadlines; the notifier fires
+    // when a deadline has passed
+    FrameClock frameClock;
+    QSocketNotifier* frameNotifier;
     bool isWon;
+    bool isRewinding;
+    bool showHints;
+    bool showPrediction;
+
+    // Last seconds of play for rewind
+    RewindBuffer history;
+
+    // Compiled levels replacing the built-in ones with the same id,
+    // enabled with TILTGOLF_LEVELS=<pack>
+    LevelPack levelPack;
+    // Level worlds built in the background: the built-in levels at startup,
+    // then the loaded level and the next on every load. After levelPack: the
+    // build reads the mapped levels.
+    LevelCache levelCache;
+
+    // Input log for replays, enabled with TILTGOLF_RECORD=<file>
+    InputRecorder recorder;
+    // Ball path per tick, enabled with TILTGOLF_TRAJECTORY=<file>
+    TrajectoryWriter trajectory;
+
+    // Rebuilt in the background on every loadLevel() while hints are enabled
+    FlowField flowField;
+    // Updated after every tick while enabled
+    Prediction prediction;
 };
 
 #endif
\ No newline at end of file
@@ -26,6 +26,7 @@ GameScreen::GameScreen(QWidget *parent) : QWidget(parent) {
     timerLabel = new QLabel(QString("Time: %1").arg(timeElapsed));
     
     restartButton = new QPushButton("Restart");
+    rewindButton = new QPushButton("Rewind");
     exitButton = new QPushButton("Exit");
     calibrateButton = new QPushButton("Calibrate"); // new
 
@@ -35,6 +36,7 @@ GameScreen::GameScreen(QWidget *parent) : QWidget(parent) {
     topBar->addWidget(timerLabel);
     topBar->addStretch();
     topBar->addWidget(calibrateButton); // add calibrate button to top bar
+    topBar->addWidget(rewindButton);
     topBar->addWidget(restartButton);
     topBar->addWidget(exitButton);
 
@@ -50,6 +52,10 @@ GameScreen::GameScreen(QWidget *parent) : QWidget(parent) {
         restartLevel();
     });
 
+    // Rewind: runs the ball back one tick per frame while held
+    connect(rewindButton, &QPushButton::pressed, controller, &GameController::startRewind);
+    connect(rewindButton, &QPushButton::released, controller, &GameController::stopRewind);
+
     // Exit: pause the running controller before switching screens so the game loop stops
     connect(exitButton, &QPushButton::clicked, [this]()
             {
@@ -181,6 +187,10 @@ void GameScreen::resetAttemptCounter() {
     attemptCount = 1;
 }
 
+LevelRating GameScreen::levelRating(int levelId) const {
+    return controller->getRating(levelId);
+}
+
 void GameScreen::setTotalLevels(int total) {
     totalLevels = total;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include <QPushButton>
 #include <QTimer>
 
+#include "LevelData.h"
+
 // Forward declarations to avoid circular includes
 class GameController;
 class GameView;
@@ -25,6 +27,8 @@ public:
     void setFreePlayMode(bool enabled);
     void resetAttemptCounter();
     void setTotalLevels(int total);
+    // Par and difficulty for the menu
+    LevelRating levelRating(int levelId) const;
 
 signals:
     void exitToMenu();
@@ -49,6 +53,7 @@ private:
     QLabel *levelLabel;
     QLabel *timerLabel;
     QPushButton *restartButton;
+    QPushButton *rewindButton; // hold to scrub back in time
     QPushButton *exitButton;
     QPushButton *calibrateButton; // new: button to trigger mag calibration
 
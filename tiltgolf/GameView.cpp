@@ -1,4 +1,5 @@
 #include "GameView.h"
+#include "Profiler.h"
 #include <QPolygonF>
 
 GameView::GameView(GameController *controller, QWidget *parent)
@@ -19,6 +20,7 @@ void GameView::updateView() {
 }
 
 void GameView::paintEvent(QPaintEvent *) {
+    PROFILE_ZONE("GameView::paintEvent");
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
 
@@ -27,7 +29,7 @@ void GameView::paintEvent(QPaintEvent *) {
     QColor groundColor(34, 139, 34); // same forest green as before
     painter.fillRect(rect(), groundColor);
 
-    LevelConfig level = controller->getCurrentLevel();
+    const LevelConfig& level = controller->getCurrentLevel();
     b2Vec2 ballPos = controller->getBallPos();
 
     // 1. Draw Water (Blue)
@@ -97,14 +99,45 @@ void GameView::paintEvent(QPaintEvent *) {
     float startRadius = toPixels(0.6f);
     painter.drawEllipse(startCenter, startRadius, startRadius);
 
+    // Ghost path under the held tilt, dotted; red where it ends in water,
+    // yellow where it ends in the hole
+    const Prediction& prediction = controller->getPrediction();
+    if (controller->predictionEnabled() && prediction.pointCount() > 1) {
+        QColor ghost(255, 255, 255, 170);
+        if (prediction.ending() == Prediction::WATER) ghost = QColor(255, 80, 80, 200);
+        if (prediction.ending() == Prediction::HOLE) ghost = QColor(255, 220, 0, 200);
+        QPolygonF path;
+        for (int i = 0; i < prediction.pointCount(); ++i)
+            path << toPixels(prediction.points()[i]);
+        painter.setBrush(Qt::NoBrush);
+        painter.setPen(QPen(ghost, 2, Qt::DotLine));
+        painter.drawPolyline(path);
+    }
+
     // Draw Ball (White)
     painter.setBrush(Qt::white);
     painter.setPen(Qt::black);
     
     QPointF ballCenter = toPixels(ballPos);
-    float ballRadius = toPixels(0.5f); // 0.5m radius from PhysicsEngine
+    float ballRadius = toPixels(BALL_RADIUS);
     
     painter.drawEllipse(ballCenter, ballRadius, ballRadius);
+
+    // Hint: an arrow from the ball's edge along the way to the hole
+    const FlowField& field = controller->getFlowField();
+    if (controller->hintsEnabled() && field.ready() && field.levelId() == level.id) {
+        b2Vec2 dir = field.direction(ballPos);
+        if (dir.LengthSquared() > 0.0f) {
+            QPointF from = toPixels(ballPos + (BALL_RADIUS * 1.3f) * dir);
+            QPointF to = toPixels(ballPos + (BALL_RADIUS * 3.0f) * dir);
+            QPointF side = toPixels(b2Vec2(-dir.y, dir.x)) * 0.25f;
+            QPointF back = to - (to - from) * 0.4f;
+            painter.setPen(QPen(QColor(255, 255, 255, 200), 2));
+            painter.drawLine(from, to);
+            painter.drawLine(to, back + side);
+            painter.drawLine(to, back - side);
+        }
+    }
 }
 
 // Convert a world-space vector (meters) to screen pixels using compile-time PPM
@@ -0,0 +1,73 @@
+#include "GridSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+const int GridSearch::DC[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+const int GridSearch::DR[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+float GridSearch::boxDistance(const b2Vec2 &p, const b2Vec2 &centre, const b2Vec2 &half) {
+    float dx = std::max(std::fabs(p.x - centre.x) - half.x, 0.0f);
+    float dy = std::max(std::fabs(p.y - centre.y) - half.y, 0.0f);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+void GridSearch::toHole(int cols, int rows, float cell, const std::vector<char> &passable, const b2Vec2 &hole,
+                        const std::vector<float> *weight, std::vector<float> &cost, std::vector<float> *metres,
+                        std::vector<int> *parent) {
+    int count = cols * rows;
+    cost.assign(count, -1.0f);
+    if (metres) metres->assign(count, -1.0f);
+    if (parent) parent->assign(count, -1);
+
+    // The hole's cell, or the closest free one if a wall or water covers it
+    int c0 = static_cast<int>(std::floor(hole.x / cell));
+    int r0 = static_cast<int>(std::floor(hole.y / cell));
+    int goal = c0 >= 0 && c0 < cols && r0 >= 0 && r0 < rows ? r0 * cols + c0 : -1;
+    if (goal < 0 || !passable[goal]) {
+        float best = 1.0f;
+        goal = -1;
+        for (int n = 0; n < count; ++n) {
+            b2Vec2 p((n % cols + 0.5f) * cell, (n / cols + 0.5f) * cell);
+            float d = (p - hole).Length();
+            if (passable[n] && d < best) {
+                best = d;
+                goal = n;
+            }
+        }
+    }
+    if (goal < 0)
+        return;
+
+    typedef std::pair<float, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+    b2Vec2 centre((goal % cols + 0.5f) * cell, (goal / cols + 0.5f) * cell);
+    cost[goal] = (centre - hole).Length();
+    if (metres) (*metres)[goal] = cost[goal];
+    if (parent) (*parent)[goal] = goal;
+    open.push(Entry(cost[goal], goal));
+
+    const float diagonal = cell * std::sqrt(2.0f);
+    while (!open.empty()) {
+        Entry e = open.top();
+        open.pop();
+        if (e.first > cost[e.second]) continue;
+        int c = e.second % cols, r = e.second / cols;
+        for (int k = 0; k < 8; ++k) {
+            int nc = c + DC[k], nr = r + DR[k];
+            if (nc < 0 || nc >= cols || nr < 0 || nr >= rows) continue;
+            int n = nr * cols + nc;
+            if (!passable[n]) continue;
+            if (k >= 4 && (!passable[r * cols + nc] || !passable[nr * cols + c])) continue;
+            float step = k >= 4 ? diagonal : cell;
+            float d = e.first + (weight ? step * (*weight)[n] : step);
+            if (cost[n] < 0.0f || d < cost[n]) {
+                cost[n] = d;
+                if (metres) (*metres)[n] = (*metres)[e.second] + step;
+                if (parent) (*parent)[n] = e.second;
+                open.push(Entry(d, n));
+            }
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef GRIDSEARCH_H
+#define GRIDSEARCH_H
+
+#include <vector>
+
+#include "box2d/box2d.h"
+
+// Shortest ways to the hole over a level cut into square cells, shared by the
+// bot planner (TiltBot) and the flow field (FlowField) so both agree on which
+// cells connect.
+//
+// Cells are numbered row by row. Moves go to the 8 neighbours; a diagonal
+// move may not cut the corner of a blocked cell.
+class GridSearch {
+public:
+    // Neighbour offsets, the four straight ones first
+    static const int DC[8];
+    static const int DR[8];
+
+    // Distance from p to an axis-aligned box, 0 inside
+    static float boxDistance(const b2Vec2 &p, const b2Vec2 &centre, const b2Vec2 &half);
+
+    // Dijkstra from the hole's cell, or from the closest free cell within 1 m
+    // if the hole's is blocked. A step into cell n costs its length times
+    // weight[n] (times 1 without weights). cost gets each cell's cost to the
+    // hole, < 0 if blocked or cut off; metres, if given, the length of that
+    // way, and parent the next cell along it (the goal points at itself).
+    static void toHole(int cols, int rows, float cell, const std::vector<char> &passable, const b2Vec2 &hole,
+                       const std::vector<float> *weight, std::vector<float> &cost,
+                       std::vector<float> *metres = nullptr, std::vector<int> *parent = nullptr);
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "IMU.h"
+#include "Profiler.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
@@ -60,6 +61,7 @@ bool IMU::begin() {
 }
 
 void IMU::update() {
+    PROFILE_ZONE("IMU::update");
     if (i2c_fd < 0) return;
 
     // Ensure we are talking to the Magnetometer 
@@ -78,18 +80,15 @@ void IMU::update() {
 }
 
 int16_t IMU::getX() const {
-    int32_t val = static_cast<int32_t>(mx) - bias_x - temp_bias_x;
-    return static_cast<int16_t>(val);
+    return applyBias(mx, bias_x + temp_bias_x);
 }
 
 int16_t IMU::getY() const {
-    int32_t val = static_cast<int32_t>(my) - bias_y - temp_bias_y;
-    return static_cast<int16_t>(val);
+    return applyBias(my, bias_y + temp_bias_y);
 }
 
 int16_t IMU::getZ() const {
-    int32_t val = static_cast<int32_t>(mz) - bias_z - temp_bias_z;
-    return static_cast<int16_t>(val);
+    return applyBias(mz, bias_z + temp_bias_z);
 }
 
 bool IMU::calibrateNow() {
@@ -19,6 +19,16 @@ public:
     int16_t getY() const;
     int16_t getZ() const;
 
+    // Uncalibrated reading and the total bias (saved + temp) subtracted from it,
+    // for recording: getX() == applyBias(getRawX(), getBiasX())
+    int16_t getRawX() const { return mx; }
+    int16_t getRawY() const { return my; }
+    int32_t getBiasX() const { return bias_x + temp_bias_x; }
+    int32_t getBiasY() const { return bias_y + temp_bias_y; }
+    static int16_t applyBias(int16_t raw, int32_t bias) {
+        return static_cast<int16_t>(static_cast<int32_t>(raw) - bias);
+    }
+
     // Simple immediate calibration (in-memory only)
     // Set the current raw reading as the saved bias so that current pose becomes "zero".
     bool calibrateNow();
@@ -0,0 +1,149 @@
+#include "LevelCache.h"
+#include "PhysicsEngine.h"
+
+#include <chrono>
+#include <iostream>
+
+static int64_t elapsedNs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Same arrays, not just the same id: a pack may replace a built-in level
+static bool sameSource(const LevelView &a, const LevelView &b) {
+    return a.id == b.id && a.walls == b.walls && a.wallCount == b.wallCount && a.water == b.water &&
+           a.waterCount == b.waterCount && a.movingWater == b.movingWater && a.movingWaterCount == b.movingWaterCount;
+}
+
+LevelCache::LevelCache(int maxTemplates) : limit(maxTemplates), useClock(0) {
+    resetStats();
+    counters.templates = 0;
+    counters.evicted = 0;
+    counters.buildNs = 0;
+}
+
+LevelCache::~LevelCache() {
+    wait();
+    for (LevelTemplate *t : templates) {
+        delete t->world;
+        delete t;
+    }
+}
+
+void LevelCache::prepare(const std::vector<LevelView> &levels) {
+    worker.post([this, levels]() { build(levels); });
+}
+
+void LevelCache::prepareBuiltin() {
+    std::vector<LevelView> levels;
+    for (int id = 1; id <= LevelData::LEVEL_COUNT; ++id)
+        levels.push_back(LevelData::builtin(id));
+    prepare(levels);
+}
+
+void LevelCache::wait() {
+    worker.wait();
+}
+
+// Already built: counts as a use, so it is not the next to go
+bool LevelCache::cached(const LevelView &level) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (LevelTemplate *t : templates) {
+        if (sameSource(t->source, level)) {
+            t->lastUse = ++useClock;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LevelCache::build(const std::vector<LevelView> &levels) {
+    for (const LevelView &view : levels) {
+        if (cached(view))
+            continue;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        LevelTemplate *t = new LevelTemplate(PhysicsEngine::LEVEL_ARENA_BYTES);
+        t->source = view;
+        LevelData::assign(t->level, view);
+        t->world = PhysicsEngine::createWorld(t->level, t->arena, &t->ball, &t->thinnestWall);
+        t->startState.resize(t->world->GetStateSize());
+        t->startState.resize(t->world->SaveState(t->startState.data(), static_cast<int32>(t->startState.size())));
+        t->buildNs = elapsedNs(start);
+        t->inUse = false;
+
+        // Published only once complete; the game thread never sees a half-built world
+        LevelTemplate *dropped = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (limit > 0 && static_cast<int>(templates.size()) >= limit) {
+                // Least recently used of those not lent out; if all are, go over for now
+                std::vector<LevelTemplate *>::iterator oldest = templates.end();
+                for (std::vector<LevelTemplate *>::iterator it = templates.begin(); it != templates.end(); ++it) {
+                    if (!(*it)->inUse && (oldest == templates.end() || (*it)->lastUse < (*oldest)->lastUse))
+                        oldest = it;
+                }
+                if (oldest != templates.end()) {
+                    dropped = *oldest;
+                    templates.erase(oldest);
+                    counters.evicted++;
+                }
+            }
+            t->lastUse = ++useClock;
+            templates.push_back(t);
+            counters.templates++;
+            counters.buildNs += t->buildNs;
+        }
+        if (dropped) {
+            delete dropped->world;
+            delete dropped;
+        }
+    }
+}
+
+LevelTemplate *LevelCache::acquire(const LevelView &level) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (LevelTemplate *t : templates) {
+        if (!t->inUse && sameSource(t->source, level)) {
+            t->inUse = true;
+            t->lastUse = ++useClock;
+            return t;
+        }
+    }
+    return nullptr;
+}
+
+void LevelCache::release(LevelTemplate *level) {
+    std::lock_guard<std::mutex> lock(mutex);
+    level->inUse = false;
+}
+
+void LevelCache::recordLoad(bool hit, int64_t ns) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (hit) {
+        counters.hits++;
+        counters.hitNs += ns;
+    } else {
+        counters.misses++;
+        counters.missNs += ns;
+    }
+}
+
+LevelCache::Stats LevelCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void LevelCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.hits = counters.misses = 0;
+    counters.hitNs = counters.missNs = 0;
+}
+
+void LevelCache::report(std::ostream &out, const char *name) const {
+    Stats s = stats();
+    double hitUs = s.hits ? s.hitNs / 1000.0 / s.hits : 0.0;
+    double missUs = s.misses ? s.missNs / 1000.0 / s.misses : 0.0;
+    out << name << ": " << s.templates << " templates built in " << s.buildNs / 1000 << " us, " << s.evicted
+        << " evicted, " << s.hits
+        << " hits (mean load " << hitUs << " us), " << s.misses << " misses (mean load " << missUs << " us)"
+        << std::endl;
+}
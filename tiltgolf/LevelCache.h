@@ -0,0 +1,101 @@
+#ifndef LEVELCACHE_H
+#define LEVELCACHE_H
+
+#include <stdint.h>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "box2d/box2d.h"
+#include "BackgroundWorker.h"
+#include "LevelData.h"
+
+// One level built once: geometry copied out of its source, the Box2D world
+// with every body in place, and that world's state right after building.
+// Owned by a LevelCache and lent to one PhysicsEngine at a time.
+struct LevelTemplate {
+    explicit LevelTemplate(int32 arenaBytes) : arena(arenaBytes), world(nullptr), ball(nullptr) {}
+
+    LevelView source;       // identifies the level: same id and arrays
+    LevelConfig level;      // pristine copy (moving water at its start)
+    float thinnestWall;
+    b2ArenaAllocator arena; // backs the world's small objects
+    b2World *world;
+    b2Body *ball;
+    std::vector<uint8_t> startState; // b2World::SaveState() of the fresh world
+    int64_t buildNs;
+    uint64_t lastUse;       // LevelCache use clock at build or last borrow
+    bool inUse;
+};
+
+// Prebuilt level worlds, so switching levels or replaying one does not
+// rebuild Box2D bodies.
+//
+// prepare() builds a template per level on a background worker. While a
+// template is free, PhysicsEngine::loadLevel() with a LevelView from the same
+// source (the built-in tables or the same mapped pack) borrows it instead of
+// building: it swaps in the template's world and restores the fresh state,
+// which gives exactly the world a rebuild would. A level that is not ready
+// yet, from another source or already lent out is built as before and
+// counted as a miss.
+//
+// Each template holds a live world and its own level arena (over 128 KB), so
+// with a limit set the cache keeps only that many: building one more drops
+// the free template borrowed longest ago. Levels already cached are not
+// built again, so the game can prepare the level it loads and the next one
+// on every load.
+class LevelCache {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        int64_t hitNs;        // total loadLevel() time of hits
+        int64_t missNs;       // and of misses
+        int templates;        // built so far
+        int evicted;          // dropped for the limit
+        int64_t buildNs;      // background time spent building them
+    };
+
+    // maxTemplates 0: keep every level prepared
+    explicit LevelCache(int maxTemplates = 0);
+    // Waits for the background build
+    ~LevelCache();
+
+    // Build templates for these levels in the background (returns at once).
+    // The views' arrays must stay valid until wait() returns or the cache is
+    // destroyed.
+    void prepare(const std::vector<LevelView> &levels);
+    // All built-in levels
+    void prepareBuiltin();
+    // Block until everything passed to prepare() is built
+    void wait();
+
+    Stats stats() const;
+    void resetStats();
+    // One-line summary: templates, build time, evictions, hits and misses with mean load time
+    void report(std::ostream &out, const char *name) const;
+
+private:
+    friend class PhysicsEngine;
+
+    LevelCache(const LevelCache &);
+    LevelCache &operator=(const LevelCache &);
+
+    // A free template for this level, marked in use; nullptr on a miss
+    LevelTemplate *acquire(const LevelView &level);
+    void release(LevelTemplate *level);
+    void recordLoad(bool hit, int64_t ns);
+
+    void build(const std::vector<LevelView> &levels);
+    bool cached(const LevelView &level);
+
+    mutable std::mutex mutex;
+    std::vector<LevelTemplate *> templates;
+    int limit;
+    uint64_t useClock;
+    Stats counters;
+    // Last member: destroyed first, so no build runs on a dying cache
+    BackgroundWorker worker;
+};
+
+#endif
@@ -0,0 +1,307 @@
+#include "LevelData.h"
+
+// The built-in levels, worked out by the compiler into read-only tables.
+// Every position follows from the same few measurements as before, in the
+// same order of float operations, so the geometry is unchanged bit for bit.
+
+namespace {
+
+constexpr float WORLD_W = 31.0f;     // World width (meters)
+constexpr float WORLD_H = 15.0f;     // World height (meters)
+constexpr float HOLE_RADIUS = 0.6f;  // slightly larger than the ball radius
+constexpr float WALL_THICK = 0.5f;   // Boundary wall half thickness
+
+template <typename T, int N>
+constexpr int countOf(const T (&)[N]) { return N; }
+
+// Four boundary walls placed fully inside the world: top, bottom, left, right
+#define BOUNDARY_WALLS \
+    {b2Vec2(WORLD_W * 0.5f, WALL_THICK), b2Vec2(WORLD_W * 0.5f, WALL_THICK)}, \
+    {b2Vec2(WORLD_W * 0.5f, WORLD_H - WALL_THICK), b2Vec2(WORLD_W * 0.5f, WALL_THICK)}, \
+    {b2Vec2(WALL_THICK, WORLD_H * 0.5f), b2Vec2(WALL_THICK, WORLD_H * 0.5f)}, \
+    {b2Vec2(WORLD_W - WALL_THICK, WORLD_H * 0.5f), b2Vec2(WALL_THICK, WORLD_H * 0.5f)}
+
+// Rectangle from its edges
+constexpr WallDef rect(float x1, float x2, float yTop, float yBottom) {
+    return {b2Vec2((x1 + x2) * 0.5f, (yTop + yBottom) * 0.5f), b2Vec2((x2 - x1) * 0.5f, (yBottom - yTop) * 0.5f)};
+}
+
+constexpr MovingWaterDef movingWater(b2Vec2 base, b2Vec2 size, float amplitude, float speed, float direction) {
+    return {base, base, size, amplitude, speed, 0.0f, direction};
+}
+
+// Level 1: three evenly spaced horizontal walls and a flag at the hole.
+// Layout: start near top-left, hole near bottom-left. Walls sit at 1/4, 1/2, 3/4 height and alternate which side they touch (L, R, L)
+namespace level1 {
+constexpr float MARGIN = 1.5f;            // meters from inner border for start/hole placement
+constexpr float BAR_HALF_THICK = 0.25f;   // 0.5 m tall
+constexpr float GAP = 3.0f;               // gap at the untouched end of each bar
+constexpr float BAR_HALF = ((WORLD_W - 2 * WALL_THICK) - GAP) * 0.5f;
+constexpr float CENTER_LEFT = WALL_THICK + BAR_HALF;
+constexpr float CENTER_RIGHT = WORLD_W - WALL_THICK - BAR_HALF;
+
+constexpr WallDef WALLS[] = {
+    BOUNDARY_WALLS,
+    {b2Vec2(CENTER_LEFT, WORLD_H * 0.25f), b2Vec2(BAR_HALF, BAR_HALF_THICK)},  // bar 1 (touching left)
+    {b2Vec2(CENTER_RIGHT, WORLD_H * 0.50f), b2Vec2(BAR_HALF, BAR_HALF_THICK)}, // bar 2 (touching right)
+    {b2Vec2(CENTER_LEFT, WORLD_H * 0.75f), b2Vec2(BAR_HALF, BAR_HALF_THICK)},  // bar 3 (touching left)
+};
+}
+
+// Level 2: top-right start, single horizontal bar near the top, large water region bottom-left, hole bottom-right.
+namespace level2 {
+constexpr float MARGIN = 1.5f;
+constexpr float BAR_HALF_W = (WORLD_W - WALL_THICK - 4.0f) * 0.5f; // 4 m gap on the left
+constexpr float WATER_HALF_W = WORLD_W * 0.32f;  // ~64% width coverage
+constexpr float WATER_HALF_H = WORLD_H * 0.20f;  // 40% total height
+
+constexpr WallDef WALLS[] = {
+    BOUNDARY_WALLS,
+    // Horizontal bar touching the right wall
+    {b2Vec2(WORLD_W - WALL_THICK - BAR_HALF_W, WORLD_H * 0.30f), b2Vec2(BAR_HALF_W, 0.25f)},
+};
+constexpr WallDef WATER[] = {
+    // bottom-left, small margin from the bottom
+    {b2Vec2(WATER_HALF_W + WALL_THICK, WORLD_H - WALL_THICK - WATER_HALF_H - 0.5f), b2Vec2(WATER_HALF_W, WATER_HALF_H)},
+};
+}
+
+// Level 3: two moving water blocks oscillating opposite, start top-left, hole bottom-right.
+namespace level3 {
+constexpr float MARGIN = 1.2f;
+constexpr float SLIM_HALF_W = 0.25f;
+constexpr float LEFT_HALF_H = 5.0f;
+constexpr float RIGHT_HALF_H = 4.3f;
+constexpr float WATER_HALF_W = 2.3f;
+constexpr float WATER_HALF_H = 1.8f;
+constexpr float MIN_CENTER_Y = (WALL_THICK * 2.0f) + WATER_HALF_H;             // touches top wall bottom edge
+constexpr float MAX_CENTER_Y = (WORLD_H - (WALL_THICK * 2.0f)) - WATER_HALF_H; // touches bottom wall top edge
+constexpr float BASE_Y = (MIN_CENTER_Y + MAX_CENTER_Y) * 0.5f;
+constexpr float AMP = (MAX_CENTER_Y - MIN_CENTER_Y) * 0.5f; // reach top and bottom
+constexpr float SPEED = 1.0f;                                // radians/sec (slow)
+
+constexpr WallDef WALLS[] = {
+    BOUNDARY_WALLS,
+    {b2Vec2(WORLD_W * 0.20f, (WALL_THICK * 2.0f) + LEFT_HALF_H), b2Vec2(SLIM_HALF_W, LEFT_HALF_H)},
+    {b2Vec2(WORLD_W * 0.80f, (WORLD_H - (WALL_THICK * 2.0f)) - RIGHT_HALF_H), b2Vec2(SLIM_HALF_W, RIGHT_HALF_H)},
+};
+constexpr MovingWaterDef MOVING_WATER[] = {
+    movingWater(b2Vec2(WORLD_W * 0.38f, BASE_Y), b2Vec2(WATER_HALF_W, WATER_HALF_H), AMP, SPEED, 1.0f),
+    movingWater(b2Vec2(WORLD_W * 0.62f, BASE_Y), b2Vec2(WATER_HALF_W, WATER_HALF_H), AMP, SPEED, -1.0f),
+};
+}
+
+// Level 4: scattered static water rectangles; start top-left, hole bottom-right.
+// Water near the edges keeps players from hugging them.
+namespace level4 {
+constexpr float MARGIN = 1.5f;
+constexpr float SMALL_X = 1.6f, SMALL_Y = 1.2f;
+constexpr float MED_X = 2.0f, MED_Y = 1.5f;
+constexpr float EDGE_X = WALL_THICK + 1.0f;
+constexpr float EDGE_HALF_W = 0.6f;
+constexpr float EDGE_HALF_H = 2.0f;
+
+constexpr WallDef WALLS[] = {BOUNDARY_WALLS};
+constexpr WallDef WATER[] = {
+    // Gaps wide enough for the ball in some spots
+    {b2Vec2(WORLD_W * 0.26f, WORLD_H * 0.22f), b2Vec2(MED_X, MED_Y)},
+    {b2Vec2(WORLD_W * 0.58f, WORLD_H * 0.20f), b2Vec2(MED_X, SMALL_Y)},
+    {b2Vec2(WORLD_W * 0.80f, WORLD_H * 0.32f), b2Vec2(SMALL_X, MED_Y)},
+    {b2Vec2(WORLD_W * 0.22f, WORLD_H * 0.50f), b2Vec2(SMALL_X, MED_Y)},
+    {b2Vec2(WORLD_W * 0.50f, WORLD_H * 0.50f), b2Vec2(MED_X, MED_Y)},
+    {b2Vec2(WORLD_W * 0.76f, WORLD_H * 0.52f), b2Vec2(SMALL_X, MED_Y)},
+    {b2Vec2(WORLD_W * 0.30f, WORLD_H * 0.74f), b2Vec2(MED_X, SMALL_Y)},
+    {b2Vec2(WORLD_W * 0.56f, WORLD_H * 0.78f), b2Vec2(SMALL_X, SMALL_Y)},
+    {b2Vec2(WORLD_W * 0.80f, WORLD_H * 0.72f), b2Vec2(SMALL_X, SMALL_Y)},
+    // Edge strips, leaving small gaps near start and hole: two left, one right
+    {b2Vec2(EDGE_X, WORLD_H * 0.35f), b2Vec2(EDGE_HALF_W, EDGE_HALF_H)},
+    {b2Vec2(EDGE_X, WORLD_H * 0.80f), b2Vec2(EDGE_HALF_W, EDGE_HALF_H)},
+    {b2Vec2(WORLD_W - EDGE_X, WORLD_H * 0.40f), b2Vec2(EDGE_HALF_W, EDGE_HALF_H)},
+    // Top and bottom
+    {b2Vec2(WORLD_W * 0.60f, WALL_THICK + 0.8f), b2Vec2(3.0f, 0.6f)},
+    {b2Vec2(WORLD_W * 0.50f, WORLD_H - WALL_THICK - 0.8f), b2Vec2(4.0f, 0.6f)},
+};
+}
+
+// Level 5: top-right pool and bottom-left pool with uniform gaps (double ball width) and aligned bumpers.
+namespace level5 {
+constexpr float MARGIN = 1.2f;
+constexpr float GAP = (0.5f * 2.0f) * 2.0f; // 2x ball width
+
+// Bottom-left water: ~50% height of gamescreen & leaves a gap to the right for goal
+constexpr float BOTTOM_TOP = WORLD_H * 0.50f;
+constexpr float BOTTOM_BOTTOM = WORLD_H - WALL_THICK - 0.2f;
+constexpr float BOTTOM_LEFT = WALL_THICK + 0.6f;
+constexpr float BOTTOM_RIGHT = WORLD_W - WALL_THICK - GAP;
+
+// Top-right water: from the top wall down to 2m above the lower water
+constexpr float TOP_BOTTOM = BOTTOM_TOP - GAP;
+constexpr float TOP_TOP = WALL_THICK + 0.2f;
+constexpr float TOP_LEFT = WALL_THICK + GAP; // 2m start margin
+constexpr float TOP_RIGHT = WORLD_W - WALL_THICK - 0.6f;
+
+// Vertical post on the left edge of the top pool, from the top wall to the pool gap
+constexpr float VERT_TOP = WALL_THICK * 2.0f;
+constexpr float VERT_HALF_H = (TOP_BOTTOM - VERT_TOP) * 0.5f;
+
+constexpr WallDef WALLS[] = {
+    BOUNDARY_WALLS,
+    {b2Vec2(TOP_LEFT, VERT_TOP + VERT_HALF_H), b2Vec2(0.15f, VERT_HALF_H)},
+    // Horizontal bar from the post, sitting on the lower pool's top edge
+    {b2Vec2(TOP_LEFT + 4.0f, BOTTOM_TOP - 0.15f), b2Vec2(4.0f, 0.15f)},
+};
+constexpr WallDef WATER[] = {
+    rect(BOTTOM_LEFT, BOTTOM_RIGHT, BOTTOM_TOP, BOTTOM_BOTTOM),
+    rect(TOP_LEFT, TOP_RIGHT, TOP_TOP, TOP_BOTTOM),
+};
+}
+
+// Level 6: dangerous ball-width path and a U-turn around wall.
+namespace level6 {
+constexpr float LANE = 1.0f; // corridors same width as the ball
+
+// Inner playfield bounds
+constexpr float INNER_LEFT = WALL_THICK * 2.0f;
+constexpr float INNER_RIGHT = WORLD_W - WALL_THICK * 2.0f;
+constexpr float INNER_TOP = WALL_THICK * 2.0f;
+constexpr float INNER_BOTTOM = WORLD_H - WALL_THICK * 2.0f;
+
+// Start and hole in the right lane
+constexpr float RIGHT_LANE_LEFT = INNER_RIGHT - LANE;
+constexpr float RIGHT_LANE_X = RIGHT_LANE_LEFT + LANE * 0.5f;
+
+// Horizontal wall at mid height with a small vertical stub ~30% from the left
+constexpr float WALL_Y = 7.5f;
+constexpr float WALL_HALF_H = 0.15f;
+constexpr float STUB_HALF_W = 0.15f;
+constexpr float STUB_HALF_H = 1.4f;
+constexpr float STUB_X = WORLD_W * 0.30f;
+constexpr float WALL_HALF_W = ((WORLD_W - WALL_THICK) - STUB_X) * 0.5f;
+
+// Ball-width clearance around the walls
+constexpr float TOP_BAND_BOTTOM = WALL_Y - WALL_HALF_H - LANE;
+constexpr float BOTTOM_BAND_TOP = WALL_Y + WALL_HALF_H + LANE;
+constexpr float LEFT_STOP = STUB_X - STUB_HALF_W - LANE;
+constexpr float RIGHT_START = STUB_X + STUB_HALF_W + LANE;
+
+constexpr WallDef WALLS[] = {
+    BOUNDARY_WALLS,
+    {b2Vec2(STUB_X + WALL_HALF_W, WALL_Y), b2Vec2(WALL_HALF_W, WALL_HALF_H)},
+    {b2Vec2(STUB_X, WALL_Y), b2Vec2(STUB_HALF_W, STUB_HALF_H)},
+};
+constexpr WallDef WATER[] = {
+    rect(INNER_LEFT, LEFT_STOP, INNER_TOP, INNER_BOTTOM),                    // left column
+    rect(LEFT_STOP, RIGHT_START, INNER_TOP, TOP_BAND_BOTTOM - LANE),         // upper connector
+    rect(LEFT_STOP, RIGHT_START, BOTTOM_BAND_TOP + LANE, INNER_BOTTOM),      // lower connector
+    rect(RIGHT_START, RIGHT_LANE_LEFT, INNER_TOP, TOP_BAND_BOTTOM),          // top main water
+    rect(RIGHT_START, RIGHT_LANE_LEFT, BOTTOM_BAND_TOP, INNER_BOTTOM),       // bottom main water
+};
+}
+
+#undef BOUNDARY_WALLS
+
+// Par, success rate and median time from tools/headless --rate (64 rollouts,
+// noise 0..400, seed 1; identical on 1 and 4 threads); rerun it after
+// changing a level, the bot or Box2D
+constexpr LevelRating RATINGS[LevelData::LEVEL_COUNT] = {
+    {60.0f, 1.000f, 52.89f},
+    {30.0f, 0.906f, 26.33f},
+    {24.0f, 0.578f, 23.07f},
+    {19.0f, 0.734f, 16.33f},
+    {28.0f, 0.688f, 24.39f},
+    {61.0f, 0.344f, 58.72f},
+};
+
+constexpr LevelView BUILTIN_LEVELS[LevelData::LEVEL_COUNT] = {
+    {1, b2Vec2(WALL_THICK + level1::MARGIN, WALL_THICK + level1::MARGIN + 0.5f),
+     b2Vec2(WALL_THICK + level1::MARGIN + 1.0f, WORLD_H - WALL_THICK - level1::MARGIN), HOLE_RADIUS,
+     level1::WALLS, countOf(level1::WALLS), nullptr, 0, nullptr, 0,
+     WORLD_W, WORLD_H, RATINGS[0]},
+    {2, b2Vec2(WORLD_W - WALL_THICK - level2::MARGIN, WALL_THICK + level2::MARGIN),
+     b2Vec2(WORLD_W - WALL_THICK - level2::MARGIN, WORLD_H - WALL_THICK - level2::MARGIN), HOLE_RADIUS,
+     level2::WALLS, countOf(level2::WALLS), level2::WATER, countOf(level2::WATER), nullptr, 0,
+     WORLD_W, WORLD_H, RATINGS[1]},
+    {3, b2Vec2(WALL_THICK + level3::MARGIN, WALL_THICK + level3::MARGIN),
+     b2Vec2(WORLD_W - WALL_THICK - level3::MARGIN, WORLD_H - WALL_THICK - level3::MARGIN), HOLE_RADIUS,
+     level3::WALLS, countOf(level3::WALLS), nullptr, 0, level3::MOVING_WATER, countOf(level3::MOVING_WATER),
+     WORLD_W, WORLD_H, RATINGS[2]},
+    {4, b2Vec2(WALL_THICK + level4::MARGIN, WALL_THICK + level4::MARGIN),
+     b2Vec2(WORLD_W - WALL_THICK - level4::MARGIN, WORLD_H - WALL_THICK - level4::MARGIN), HOLE_RADIUS,
+     level4::WALLS, countOf(level4::WALLS), level4::WATER, countOf(level4::WATER), nullptr, 0,
+     WORLD_W, WORLD_H, RATINGS[3]},
+    {5, b2Vec2(WALL_THICK + level5::MARGIN, WALL_THICK + level5::MARGIN),
+     b2Vec2(WORLD_W - WALL_THICK - level5::MARGIN, WORLD_H - WALL_THICK - level5::MARGIN), HOLE_RADIUS,
+     level5::WALLS, countOf(level5::WALLS), level5::WATER, countOf(level5::WATER), nullptr, 0,
+     WORLD_W, WORLD_H, RATINGS[4]},
+    {6, b2Vec2(level6::RIGHT_LANE_X, level6::INNER_BOTTOM - level6::LANE * 0.5f),
+     b2Vec2(level6::RIGHT_LANE_X, level6::INNER_TOP + level6::LANE * 0.5f), HOLE_RADIUS,
+     level6::WALLS, countOf(level6::WALLS), level6::WATER, countOf(level6::WATER), nullptr, 0,
+     WORLD_W, WORLD_H, RATINGS[5]},
+};
+
+// --- Compile-time placement checks ---
+// A ball resting on the start or the hole must not overlap a wall, still
+// water or anywhere moving water can reach, and must not start in the hole.
+// Touching is fine; PLACEMENT_SLOP absorbs float rounding at shared edges.
+constexpr float PLACEMENT_SLOP = 0.001f;
+
+constexpr float square(float v) { return v * v; }
+constexpr float outside(float d, float half) { return d - half > 0.0f ? d - half : 0.0f; }
+constexpr float distanceOutside(float p, float centre, float half) {
+    return p > centre ? outside(p - centre, half) : outside(centre - p, half);
+}
+
+constexpr bool ballOverlaps(b2Vec2 ball, b2Vec2 centre, b2Vec2 half) {
+    return square(distanceOutside(ball.x, centre.x, half.x)) + square(distanceOutside(ball.y, centre.y, half.y)) <
+           square(BALL_RADIUS - PLACEMENT_SLOP);
+}
+
+constexpr bool clearOf(b2Vec2 ball, const WallDef *defs, int count) {
+    return count == 0 || (!ballOverlaps(ball, defs->position, defs->size) && clearOf(ball, defs + 1, count - 1));
+}
+
+// Moving water counts as its whole sweep
+constexpr bool clearOf(b2Vec2 ball, const MovingWaterDef *defs, int count) {
+    return count == 0 ||
+           (!ballOverlaps(ball, defs->basePosition,
+                          b2Vec2(defs->size.x, defs->size.y + (defs->amplitude < 0.0f ? -defs->amplitude : defs->amplitude))) &&
+            clearOf(ball, defs + 1, count - 1));
+}
+
+constexpr bool restsFreely(const LevelView &level, b2Vec2 ball) {
+    return ball.x - BALL_RADIUS >= 0.0f && ball.x + BALL_RADIUS <= level.width && ball.y - BALL_RADIUS >= 0.0f &&
+           ball.y + BALL_RADIUS <= level.height && clearOf(ball, level.walls, level.wallCount) &&
+           clearOf(ball, level.water, level.waterCount) && clearOf(ball, level.movingWater, level.movingWaterCount);
+}
+
+constexpr bool placementValid(const LevelView &level) {
+    return restsFreely(level, level.ballStartPos) && restsFreely(level, level.holePos) &&
+           square(level.ballStartPos.x - level.holePos.x) + square(level.ballStartPos.y - level.holePos.y) >
+               square(level.holeRadius + BALL_RADIUS);
+}
+
+static_assert(placementValid(BUILTIN_LEVELS[0]), "level 1: start or hole overlaps a wall, water or each other");
+static_assert(placementValid(BUILTIN_LEVELS[1]), "level 2: start or hole overlaps a wall, water or each other");
+static_assert(placementValid(BUILTIN_LEVELS[2]), "level 3: start or hole overlaps a wall, water or each other");
+static_assert(placementValid(BUILTIN_LEVELS[3]), "level 4: start or hole overlaps a wall, water or each other");
+static_assert(placementValid(BUILTIN_LEVELS[4]), "level 5: start or hole overlaps a wall, water or each other");
+static_assert(placementValid(BUILTIN_LEVELS[5]), "level 6: start or hole overlaps a wall, water or each other");
+
+}
+
+LevelView LevelData::builtin(int id) {
+    // Unknown ids get the level 1 layout, as they always have
+    LevelView level = BUILTIN_LEVELS[id >= 1 && id <= LEVEL_COUNT ? id - 1 : 0];
+    level.id = id;
+    return level;
+}
+
+bool LevelData::checkPlacement(const LevelView &level) {
+    return placementValid(level);
+}
+
+LevelConfig LevelData::getLevel(int id) {
+    LevelConfig level;
+    assign(level, builtin(id));
+    return level;
+}
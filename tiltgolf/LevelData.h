@@ -9,6 +9,9 @@
 // Conversion factor: 15 pixels = 1 meter (compile-time constant)
 const float PPM = 15.0f;
 
+// Ball radius in meters
+constexpr float BALL_RADIUS = 0.5f;
+
 struct WallDef {
     b2Vec2 position; // Center position in meters
     b2Vec2 size;     // Half-width and Half-height in meters
@@ -24,6 +27,14 @@ struct MovingWaterDef {
     float direction;     // 1.0 or -1.0 to invert motion
 };
 
+// How a level plays, from Difficulty (tools/headless --rate); all zero for a
+// level that has not been rated
+struct LevelRating {
+    float parSeconds;
+    float successRate;   // 0..1, rollouts in the hole without touching water
+    float medianSeconds;
+};
+
 struct LevelConfig {
     int id;
     b2Vec2 ballStartPos;
@@ -34,306 +45,77 @@ struct LevelConfig {
     std::vector<MovingWaterDef> movingWater;
     float width;  // World width in meters
     float height; // World height in meters
+    LevelRating rating;
+};
+
+// Read-only level in contiguous arrays, e.g. straight out of a mapped level
+// pack (LevelPack.h). The arrays belong to whoever produced the view.
+struct LevelView {
+    int id;
+    b2Vec2 ballStartPos;
+    b2Vec2 holePos;
+    float holeRadius;
+    const WallDef *walls;
+    int wallCount;
+    const WallDef *water;
+    int waterCount;
+    const MovingWaterDef *movingWater;
+    int movingWaterCount;
+    float width;
+    float height;
+    LevelRating rating;
 };
 
 class LevelData {
 public:
-    static LevelConfig getLevel(int id) {
-        LevelConfig level;
-        level.id = id;
-
-        // Define World Size (meters)
-        level.width = 31.0f;
-        level.height = 15.0f;
-
-        // Default hole size (meters)
-        level.holeRadius = 0.6f; // slightly larger than the 0.5m ball radius
-
-        // Wall thickness (half-size in meters).
-        float wallThick = 0.5f;
-
-        // Clear any existing geometry (safety)
-        level.walls.clear();
-        level.water.clear();
-        level.movingWater.clear();
-
-        // --- Boundary walls (placed fully inside the world) ---
-        // Top wall: center at y = wallThick, spans full width
-        level.walls.push_back({b2Vec2(level.width * 0.5f, wallThick), b2Vec2(level.width * 0.5f, wallThick)});
-
-        // Bottom wall: center at y = height - wallThick, spans full width
-        level.walls.push_back({b2Vec2(level.width * 0.5f, level.height - wallThick), b2Vec2(level.width * 0.5f, wallThick)});
-
-        // Left wall: center at x = wallThick, spans full height
-        level.walls.push_back({b2Vec2(wallThick, level.height * 0.5f), b2Vec2(wallThick, level.height * 0.5f)});
-
-        // Right wall: center at x = width - wallThick, spans full height
-        level.walls.push_back({b2Vec2(level.width - wallThick, level.height * 0.5f), b2Vec2(wallThick, level.height * 0.5f)});
-
-        // --- Per-level placement ---
-        if (id == 2)
-        {
-            // Level 2: top-right start, single horizontal bar near the top, large water region bottom-left, hole bottom-right.
-            float margin = 1.5f;
-            level.ballStartPos.Set(level.width - wallThick - margin, wallThick + margin); // top-right
-            level.holePos.Set(level.width - wallThick - margin, level.height - wallThick - margin); // bottom-right
-
-            // Horizontal bar spanning to the right wall
-            float barHalfThickness = 0.25f;
-            float leftGap = 4.0f; // leave some gap on the left
-            float barHalfWidth = (level.width - wallThick - leftGap) * 0.5f;
-            float barCenterX = level.width - wallThick - barHalfWidth; // touching right wall
-            float barY = level.height * 0.30f;
-            level.walls.push_back({b2Vec2(barCenterX, barY), b2Vec2(barHalfWidth, barHalfThickness)});
-
-            // Water: shorter in height (~40% of screen), bottom-left region
-            float waterHalfW = level.width * 0.32f;        // ~64% width coverage
-            float waterHalfH = level.height * 0.20f;       // 40% total height
-            float waterCenterX = waterHalfW + wallThick;   // from left border inward
-            float waterCenterY = level.height - wallThick - waterHalfH - 0.5f; // small margin from bottom
-            level.water.push_back({b2Vec2(waterCenterX, waterCenterY), b2Vec2(waterHalfW, waterHalfH)});
-
-            return level;
-        }
-        if (id == 3)
-        {
-            // Level 3: two moving water blocks oscillating opposite, start top-left, hole bottom-right.
-            float margin = 1.2f;
-            level.ballStartPos.Set(wallThick + margin, wallThick + margin); // near top-left
-            level.holePos.Set(level.width - wallThick - margin, level.height - wallThick - margin); // bottom-right
-
-            // small walls
-            float slimHalfW = 0.25f;
-            float leftHalfH = 5.0f;  
-            float leftY = (wallThick * 2.0f) + leftHalfH; 
-            float rightHalfH = 4.3f; 
-            float rightY = (level.height - (wallThick * 2.0f)) - rightHalfH; 
-            level.walls.push_back({b2Vec2(level.width * 0.20f, leftY), b2Vec2(slimHalfW, leftHalfH)});
-            level.walls.push_back({b2Vec2(level.width * 0.80f, rightY), b2Vec2(slimHalfW, rightHalfH)});
-
-            // Moving water blocks (vertical oscillation, opposite directions)
-            float waterHalfW = 2.3f;
-            float waterHalfH = 1.8f;
-            float minCenterY = (wallThick * 2.0f) + waterHalfH;                  // touches top wall bottom edge
-            float maxCenterY = (level.height - (wallThick * 2.0f)) - waterHalfH; // touches bottom wall top edge
-            float baseY = (minCenterY + maxCenterY) * 0.5f;
-            float amp = (maxCenterY - minCenterY) * 0.5f;     // reach top and bottom
-            float speed = 1.0f;   // radians/sec (slow)
-
-            MovingWaterDef left;
-            left.basePosition.Set(level.width * 0.38f, baseY);
-            left.position = left.basePosition;
-            left.size.Set(waterHalfW, waterHalfH);
-            left.amplitude = amp;
-            left.speed = speed;
-            left.phase = 0.0f;
-            left.direction = 1.0f;
-
-            MovingWaterDef right;
-            right.basePosition.Set(level.width * 0.62f, baseY);
-            right.position = right.basePosition;
-            right.size.Set(waterHalfW, waterHalfH);
-            right.amplitude = amp;
-            right.speed = speed;
-            right.phase = 0.0f; 
-            right.direction = -1.0f;
-
-            level.movingWater.push_back(left);
-            level.movingWater.push_back(right);
-
-            return level;
-        }
-
-        if (id == 4)
-        {
-            // Level 4: randomly placed static water rectangles; start top-left, hole bottom-right.
-            // putting water near edges to prevent players hugging the edge.
-            float margin = 1.5f;
-            level.ballStartPos.Set(wallThick + margin, wallThick + margin); // top-left
-            level.holePos.Set(level.width - wallThick - margin, level.height - wallThick - margin); // bottom-right
-
-            // Scatter water rectangles; leave gaps wide enough for the ball in some spots
-            auto addWater = [&](float cx, float cy, float hx, float hy) {
-                level.water.push_back({b2Vec2(cx, cy), b2Vec2(hx, hy)});
-            };
-
-            float wSmallX = 1.6f, wSmallY = 1.2f;
-            float wMedX = 2.0f,  wMedY = 1.5f;
-
-            addWater(level.width * 0.26f, level.height * 0.22f, wMedX, wMedY);
-            addWater(level.width * 0.58f, level.height * 0.20f, wMedX, wSmallY);
-            addWater(level.width * 0.80f, level.height * 0.32f, wSmallX, wMedY);
-            addWater(level.width * 0.22f, level.height * 0.50f, wSmallX, wMedY);
-            addWater(level.width * 0.50f, level.height * 0.50f, wMedX, wMedY);
-            addWater(level.width * 0.76f, level.height * 0.52f, wSmallX, wMedY);
-            addWater(level.width * 0.30f, level.height * 0.74f, wMedX, wSmallY);
-            addWater(level.width * 0.56f, level.height * 0.78f, wSmallX, wSmallY);
-            addWater(level.width * 0.80f, level.height * 0.72f, wSmallX, wSmallY);
-
-            // water strips on the edges to block wall hugging (leave small gaps near start/hole)
-            float edgeXGap = wallThick + 1.0f;
-            float edgeStripHalfW = 0.6f;
-            float edgeStripHalfH = 2.0f;
-            // Left edge strips (avoiding start corner)
-            addWater(edgeXGap, level.height * 0.35f, edgeStripHalfW, edgeStripHalfH);
-            addWater(edgeXGap, level.height * 0.80f, edgeStripHalfW, edgeStripHalfH);
-            // Right edge strips
-            addWater(level.width - edgeXGap, level.height * 0.40f, edgeStripHalfW, edgeStripHalfH);
-            //addWater(level.width - edgeXGap, level.height * 0.78f, edgeStripHalfW, edgeStripHalfH);
-            // Top  
-            addWater(level.width * 0.60f, wallThick + 0.8f, 3.0f, 0.6f);
-            // Bottom 
-            addWater(level.width * 0.50f, level.height - wallThick - 0.8f, 4.0f, 0.6f);
-
-            return level;
-        }
-
-        if (id == 5)
-        {
-            // Level 5: top-right pool and bottom-left pool with uniform gaps (double ball width) and aligned bumpers.
-            float margin = 1.2f;
-            level.ballStartPos.Set(wallThick + margin, wallThick + margin); // near top-left
-            level.holePos.Set(level.width - wallThick - margin, level.height - wallThick - margin); // bottom-right
-
-            float ballDiameter = 0.5f * 2.0f;  // ball radius is 0.5m
-            float gap = ballDiameter * 2.0f;   // shared gap size (2x ball width)
-
-            // Bottom-left water: ~50% height of gamescreen & leaves a gap to the right for goal
-            float bottomTop = level.height * 0.50f;
-            float bottomBottom = level.height - wallThick - 0.2f;
-            float bottomLeft = wallThick + 0.6f;
-            float bottomRight = level.width - wallThick - gap; // 2m dry strip on the right
-            b2Vec2 bottomCenter((bottomLeft + bottomRight) * 0.5f, (bottomTop + bottomBottom) * 0.5f);
-            b2Vec2 bottomHalf((bottomRight - bottomLeft) * 0.5f, (bottomBottom - bottomTop) * 0.5f);
-            level.water.push_back({bottomCenter, bottomHalf});
-
-            // Top-right water: from the top wall down to 2m above the lower water
-            float topBottom = bottomTop - gap;         // 2m vertical gap between pools
-            float topTop = wallThick + 0.2f;
-            float topLeft = wallThick + gap;           // 2m start margin
-            float topRight = level.width - wallThick - 0.6f;
-            b2Vec2 topCenter((topLeft + topRight) * 0.5f, (topTop + topBottom) * 0.5f);
-            b2Vec2 topHalf((topRight - topLeft) * 0.5f, (topBottom - topTop) * 0.5f);
-            level.water.push_back({topCenter, topHalf});
-
-            // walls: vertical post on the left edge of the top pool, horizontal one on top of the lower pool
-            float vertHalfW = 0.15f;
-            float vertTop = wallThick * 2.0f;    // touches the bottom of the top boundary wall
-            float vertBottom = topBottom;        // stops at the pool gap
-            float vertHalfH = (vertBottom - vertTop) * 0.5f;
-            float vertCenterY = vertTop + vertHalfH;
-            float vertX = topLeft;               // aligned with top pool's left edge
-            level.walls.push_back({b2Vec2(vertX, vertCenterY), b2Vec2(vertHalfW, vertHalfH)});
-
-            float horizHalfH = 0.15f;
-            float horizHalfW = 4.0f;
-            float horizCenterX = topLeft + horizHalfW; // left end matches the vertical wall
-            float horizCenterY = bottomTop - horizHalfH; // bottom edge sits on the lower pool's top edge
-            level.walls.push_back({b2Vec2(horizCenterX, horizCenterY), b2Vec2(horizHalfW, horizHalfH)});
-
-            return level;
-        }
-
-        if (id == 6)
-        {
-            // Level 6: dangerous ball-width path and a U-turn around wall.
-            const float ballDiameter = 1.0f;
-            float lane = ballDiameter;       // corridors same width as ball diameter
-
-            // Inner playfield bounds 
-            float innerLeft = wallThick * 2.0f;               // 1.0
-            float innerRight = level.width - wallThick * 2.0f; // 30.0
-            float innerTop = wallThick * 2.0f;                // 1.0
-            float innerBottom = level.height - wallThick * 2.0f; // 14.0
-
-            // Place start/hole centered on the right
-            float rightLaneLeft = innerRight - lane;
-            float rightLaneCenterX = rightLaneLeft + lane * 0.5f;
-            level.ballStartPos.Set(rightLaneCenterX, innerBottom - lane * 0.5f); // bottom-right
-            level.holePos.Set(rightLaneCenterX, innerTop + lane * 0.5f);         // top-right
-
-            auto addWaterRect = [&](float x1, float x2, float yTop, float yBottom) {
-                float cx = (x1 + x2) * 0.5f;
-                float hx = (x2 - x1) * 0.5f;
-                float cy = (yTop + yBottom) * 0.5f;
-                float hy = (yBottom - yTop) * 0.5f;
-                level.water.push_back({b2Vec2(cx, cy), b2Vec2(hx, hy)});
-            };
-
-            // Wall placement: ~70% across from the right side 
-            float wallY = 7.5f;
-            float wallHalfH = 0.15f;
-            float stubHalfW = 0.15f;
-            float stubHalfH = 1.4f;
-            float stubX = level.width * 0.30f; // ~30% from the left 
-            float gap = lane;                  // keep ball-width clearance around the walls
-
-            float topBandBottom = wallY - wallHalfH - gap;
-            float bottomBandTop = wallY + wallHalfH + gap;
-            float upperConnectorBottom = topBandBottom - lane; 
-            float lowerConnectorTop = bottomBandTop + lane;    
-
-            float leftStop = stubX - stubHalfW - gap;
-            float rightStart = stubX + stubHalfW + gap;
-
-            // Five water rectangles: left column, two connectors, and two large water rects.
-            // Left column
-            addWaterRect(innerLeft, leftStop, innerTop, innerBottom);
-            // Upper connector into the top water rect 
-            addWaterRect(leftStop, rightStart, innerTop, upperConnectorBottom);
-            // Lower connector into the bottom water rect 
-            addWaterRect(leftStop, rightStart, lowerConnectorTop, innerBottom);
-            // Top main water rect 
-            addWaterRect(rightStart, rightLaneLeft, innerTop, topBandBottom);
-            // Bottom main water rect
-            addWaterRect(rightStart, rightLaneLeft, bottomBandTop, innerBottom);
-
-            // Horizontal wall with the u-turn on the far left
-            float wallLeft = stubX;
-            float wallRight = level.width - wallThick;
-            float wallHalfW = (wallRight - wallLeft) * 0.5f;
-            float wallCenterX = wallLeft + wallHalfW;
-            level.walls.push_back({b2Vec2(wallCenterX, wallY), b2Vec2(wallHalfW, wallHalfH)});
-
-            // Small vertical wall
-            float stubCenterX = stubX;
-            float stubCenterY = wallY; // centered on the horizontal wall
-            level.walls.push_back({b2Vec2(stubCenterX, stubCenterY), b2Vec2(stubHalfW, stubHalfH)});
-
-            return level;
-        }
-        // Default Level (id == 1 or others): three evenly spaced horizontal walls and a flag at the hole.
-        // Layout: start near top-left, hole near bottom-left. Walls sit at 1/4, 1/2, 3/4 height and alternate which side they touch (L, R, L)
-        float margin = 1.5f; // meters from inner border for start/hole placement
-        level.ballStartPos.Set(wallThick + margin, wallThick + margin + 0.5f); // top-left
-        level.holePos.Set(wallThick + margin + 1.0f, level.height - wallThick - margin); // bottom-left-ish
-
-        // Wall thickness (thin)
-        float barHalfThickness = 0.25f; // 0.5 m tall
-
-        // Three bars at 1/4, 1/2, 3/4 of the playfield height
-        float y1 = level.height * 0.25f;
-        float y2 = level.height * 0.50f;
-        float y3 = level.height * 0.75f;
+    // Levels are numbered 1..LEVEL_COUNT
+    static const int LEVEL_COUNT = 6;
+
+    // View of a LevelConfig's arrays (valid while the config is unchanged)
+    static LevelView view(const LevelConfig &level) {
+        LevelView v;
+        v.id = level.id;
+        v.ballStartPos = level.ballStartPos;
+        v.holePos = level.holePos;
+        v.holeRadius = level.holeRadius;
+        v.walls = level.walls.data();
+        v.wallCount = static_cast<int>(level.walls.size());
+        v.water = level.water.data();
+        v.waterCount = static_cast<int>(level.water.size());
+        v.movingWater = level.movingWater.data();
+        v.movingWaterCount = static_cast<int>(level.movingWater.size());
+        v.width = level.width;
+        v.height = level.height;
+        v.rating = level.rating;
+        return v;
+    }
 
-        // Left-touching bar (gap on the right)
-        float gapRight = 3.0f;
-        float lenLeft = (level.width - 2 * wallThick) - gapRight;
-        float halfLeft = lenLeft * 0.5f;
-        float centerLeft = wallThick + halfLeft;
+    // Copy a view into a LevelConfig; the vectors keep their storage, so
+    // reloading levels of similar size does not allocate
+    static void assign(LevelConfig &level, const LevelView &v) {
+        level.id = v.id;
+        level.ballStartPos = v.ballStartPos;
+        level.holePos = v.holePos;
+        level.holeRadius = v.holeRadius;
+        level.walls.assign(v.walls, v.walls + v.wallCount);
+        level.water.assign(v.water, v.water + v.waterCount);
+        level.movingWater.assign(v.movingWater, v.movingWater + v.movingWaterCount);
+        level.width = v.width;
+        level.height = v.height;
+        level.rating = v.rating;
+    }
 
-        // Right-touching bar (gap on the left)
-        float gapLeft = 3.0f;
-        float lenRight = (level.width - 2 * wallThick) - gapLeft;
-        float halfRight = lenRight * 0.5f;
-        float centerRight = level.width - wallThick - halfRight;
+    // Built-in level as a view of compile-time tables (LevelData.cpp); no
+    // allocation, the arrays live in read-only data
+    static LevelView builtin(int id);
 
-        level.walls.push_back({b2Vec2(centerLeft, y1), b2Vec2(halfLeft, barHalfThickness)});   // bar 1 (touching left)
-        level.walls.push_back({b2Vec2(centerRight, y2), b2Vec2(halfRight, barHalfThickness)}); // bar 2 (touching right)
-        level.walls.push_back({b2Vec2(centerLeft, y3), b2Vec2(halfLeft, barHalfThickness)});   // bar 3 (touching left)
+    // Built-in level copied into a LevelConfig
+    static LevelConfig getLevel(int id);
 
-        return level;
-    }
+    // The rule the built-in levels are checked against at compile time: a
+    // ball resting on the start or the hole touches no wall or water (moving
+    // water anywhere along its path), and the start is clear of the hole
+    static bool checkPlacement(const LevelView &level);
 };
 
 #endif
@@ -0,0 +1,226 @@
+#include "LevelGenerator.h"
+#include "PhysicsEngine.h"
+#include "TiltBot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+// Same frame as the built-in levels
+static const float WORLD_W = 31.0f;
+static const float WORLD_H = 15.0f;
+static const float HOLE_RADIUS = 0.6f;
+static const float WALL_THICK = 0.5f;         // boundary wall half thickness
+static const float INNER = 2.0f * WALL_THICK; // inside edge of the boundary
+
+static const float MIN_HOLE_DISTANCE = 14.0f; // start to hole, straight line
+static const float PI = 3.14159265f;
+
+namespace {
+
+// splitmix64 to seed, then xorshift64*: fixed arithmetic, so every platform
+// draws the same numbers (std:: distributions are not specified that tightly)
+class Random {
+public:
+    Random(uint64_t seed, uint64_t stream) {
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull * (stream + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        state = (z ^ (z >> 31)) | 1;
+    }
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    // Uniform in [lo, hi)
+    float range(float lo, float hi) { return lo + (hi - lo) * ((next() >> 40) * (1.0f / 16777216.0f)); }
+    // Uniform in [lo, hi]
+    int between(int lo, int hi) { return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1)); }
+    bool chance(float p) { return range(0.0f, 1.0f) < p; }
+
+private:
+    uint64_t state;
+};
+
+}
+
+static WallDef box(float cx, float cy, float hw, float hh) {
+    WallDef w;
+    w.position = b2Vec2(cx, cy);
+    w.size = b2Vec2(hw, hh);
+    return w;
+}
+
+LevelGenerator::LevelGenerator(uint64_t seed) : seed(seed) {}
+
+LevelConfig LevelGenerator::candidate(uint32_t index, int id) const {
+    Random rng(seed, index);
+    LevelConfig level;
+    level.id = id;
+    level.width = WORLD_W;
+    level.height = WORLD_H;
+    level.holeRadius = HOLE_RADIUS;
+    level.rating = LevelRating();
+
+    // Boundary: top, bottom, left, right (as BOUNDARY_WALLS in LevelData.cpp)
+    level.walls.push_back(box(WORLD_W * 0.5f, WALL_THICK, WORLD_W * 0.5f, WALL_THICK));
+    level.walls.push_back(box(WORLD_W * 0.5f, WORLD_H - WALL_THICK, WORLD_W * 0.5f, WALL_THICK));
+    level.walls.push_back(box(WALL_THICK, WORLD_H * 0.5f, WALL_THICK, WORLD_H * 0.5f));
+    level.walls.push_back(box(WORLD_W - WALL_THICK, WORLD_H * 0.5f, WALL_THICK, WORLD_H * 0.5f));
+
+    // Start anywhere a ball fits; the hole well away from it
+    const float margin = INNER + 1.0f;
+    level.ballStartPos = b2Vec2(rng.range(margin, WORLD_W - margin), rng.range(margin, WORLD_H - margin));
+    float farthest = -1.0f;
+    for (int attempt = 0; attempt < 16 && farthest < MIN_HOLE_DISTANCE; ++attempt) {
+        b2Vec2 hole(rng.range(margin, WORLD_W - margin), rng.range(margin, WORLD_H - margin));
+        float d = (hole - level.ballStartPos).Length();
+        if (d > farthest) {
+            farthest = d;
+            level.holePos = hole;
+        }
+    }
+
+    // Straight bars, some running from the boundary like the built-in ones
+    int bars = rng.between(2, 5);
+    for (int i = 0; i < bars; ++i) {
+        float halfThick = rng.range(0.2f, 0.35f);
+        if (rng.chance(0.5f)) {
+            float half = rng.range(2.0f, 8.0f);
+            float x = rng.range(INNER + half, WORLD_W - INNER - half);
+            if (rng.chance(0.4f))
+                x = rng.chance(0.5f) ? INNER + half : WORLD_W - INNER - half;
+            level.walls.push_back(box(x, rng.range(INNER + 2.0f, WORLD_H - INNER - 2.0f), half, halfThick));
+        } else {
+            float half = rng.range(1.5f, 4.5f);
+            float y = rng.range(INNER + half, WORLD_H - INNER - half);
+            if (rng.chance(0.4f))
+                y = rng.chance(0.5f) ? INNER + half : WORLD_H - INNER - half;
+            level.walls.push_back(box(rng.range(INNER + 2.0f, WORLD_W - INNER - 2.0f), y, halfThick, half));
+        }
+    }
+
+    // Still water
+    int pools = rng.between(1, 6);
+    for (int i = 0; i < pools; ++i) {
+        float hw = rng.range(0.6f, 3.0f);
+        float hh = rng.range(0.6f, 2.2f);
+        level.water.push_back(box(rng.range(INNER + hw, WORLD_W - INNER - hw), rng.range(INNER + hh, WORLD_H - INNER - hh), hw, hh));
+    }
+
+    // Moving water sweeping up and down inside the boundary
+    int movers = rng.chance(0.4f) ? rng.between(1, 2) : 0;
+    for (int i = 0; i < movers; ++i) {
+        MovingWaterDef m;
+        m.size = b2Vec2(rng.range(0.8f, 2.0f), rng.range(0.8f, 1.6f));
+        float reach = (WORLD_H - 2.0f * INNER) * 0.5f - m.size.y;
+        m.basePosition = b2Vec2(rng.range(INNER + m.size.x, WORLD_W - INNER - m.size.x), WORLD_H * 0.5f);
+        m.position = m.basePosition;
+        m.amplitude = rng.range(0.5f * reach, reach);
+        m.speed = rng.range(0.6f, 1.4f);
+        m.phase = rng.range(0.0f, 2.0f * PI);
+        m.direction = rng.chance(0.5f) ? 1.0f : -1.0f;
+        level.movingWater.push_back(m);
+    }
+    return level;
+}
+
+bool LevelGenerator::verify(PhysicsEngine &physics, uint32_t index, const LevelConfig &level, const Options &options,
+                            GeneratedLevel &result, Stats *stats) const {
+    if (!LevelData::checkPlacement(LevelData::view(level))) {
+        if (stats) stats->badPlacement++;
+        return false;
+    }
+    TiltBot bot(level);
+    if (!bot.hasPath()) {
+        if (stats) stats->noPath++;
+        return false;
+    }
+
+    physics.loadLevel(level);
+    int par = static_cast<int>(options.parSeconds * options.tickRate);
+    for (int r = 0; r < options.rollouts; ++r) {
+        if (r > 0) physics.reset();
+        // The first rollout plays clean, the others with their own noise
+        bot.setNoise(static_cast<uint32_t>(Random(seed ^ index, r).next() >> 32), r > 0 ? options.noiseCounts : 0);
+        int ticks = bot.play(physics, par);
+        if (stats) {
+            stats->rollouts++;
+            stats->ticks += ticks > 0 ? ticks : par;
+        }
+        if (ticks > 0) {
+            result.level = level;
+            result.candidate = index;
+            result.botTicks = ticks;
+            result.rollouts = r + 1;
+            return true;
+        }
+    }
+    if (stats) stats->unsolved++;
+    return false;
+}
+
+std::vector<GeneratedLevel> LevelGenerator::generate(int count, int firstId, const Options &options,
+                                                     Stats *stats) const {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+
+    // Workers claim candidate indices in order and stop once enough are kept.
+    // Indices below the count-th kept one are all claimed by then, so the
+    // lowest `count` kept ones are the same for any thread count.
+    std::atomic<uint32_t> nextIndex(0);
+    std::atomic<int> kept(0);
+    std::mutex mutex;
+    std::vector<GeneratedLevel> levels;
+    Stats total = Stats();
+
+    auto worker = [&]() {
+        PhysicsEngine physics(false);
+        physics.setTickRate(options.tickRate);
+        Stats local = Stats();
+        while (kept.load() < count) {
+            uint32_t index = nextIndex.fetch_add(1);
+            local.candidates++;
+            GeneratedLevel level;
+            if (verify(physics, index, candidate(index, 0), options, level, &local)) {
+                std::lock_guard<std::mutex> lock(mutex);
+                levels.push_back(level);
+                kept++;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        total.candidates += local.candidates;
+        total.badPlacement += local.badPlacement;
+        total.noPath += local.noPath;
+        total.unsolved += local.unsolved;
+        total.rollouts += local.rollouts;
+        total.ticks += local.ticks;
+    };
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i)
+        pool.push_back(std::thread(worker));
+    for (std::thread &t : pool)
+        t.join();
+
+    std::sort(levels.begin(), levels.end(),
+              [](const GeneratedLevel &a, const GeneratedLevel &b) { return a.candidate < b.candidate; });
+    if (static_cast<int>(levels.size()) > count)
+        levels.resize(count);
+    for (size_t i = 0; i < levels.size(); ++i)
+        levels[i].level.id = firstId + static_cast<int>(i);
+
+    if (stats) {
+        *stats = total;
+        stats->threads = threads;
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return levels;
+}
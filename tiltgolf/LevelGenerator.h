@@ -0,0 +1,65 @@
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "LevelData.h"
+
+class PhysicsEngine;
+
+struct GeneratedLevel {
+    LevelConfig level;
+    uint32_t candidate;  // index of the candidate it was drawn as
+    int botTicks;        // ticks the winning bot rollout took
+    int rollouts;        // rollouts played before one finished
+};
+
+// Seedable procedural levels from the same pieces as the built-in ones:
+// boundary walls, straight interior walls, still water, vertically moving
+// water, a start and a hole.
+//
+// candidate(i) is a pure function of the seed and i (own RNG, no library
+// distributions), so a seed names the same levels on every machine and for
+// any thread count. A candidate is kept when it passes the placement rule of
+// the built-in levels, TiltBot finds a path, and one of a few noisy bot
+// rollouts reaches the hole within par time. generate() checks candidates on
+// all cores and returns the first `count` kept ones in candidate order.
+class LevelGenerator {
+public:
+    struct Options {
+        int rollouts = 4;          // bot games per candidate, stopping at the first win
+        float parSeconds = 40.0f;  // a win has to come within this
+        int noiseCounts = 3;       // tilt error per axis in rollouts after the first
+        int tickRate = 60;
+        int threads = 0;           // 0: one per core
+    };
+
+    struct Stats {
+        uint64_t candidates;
+        uint64_t badPlacement;     // start or hole on a hazard
+        uint64_t noPath;           // walls or water cut the hole off
+        uint64_t unsolved;         // no rollout within par
+        uint64_t rollouts;
+        uint64_t ticks;            // simulated over all rollouts
+        int threads;
+        double seconds;
+    };
+
+    explicit LevelGenerator(uint64_t seed);
+
+    LevelConfig candidate(uint32_t index, int id) const;
+
+    // Placement check and bot rollouts for one candidate on this engine
+    // (which is left on the level). False if rejected; stats may be nullptr.
+    bool verify(PhysicsEngine &physics, uint32_t index, const LevelConfig &level, const Options &options,
+                GeneratedLevel &result, Stats *stats) const;
+
+    // The first `count` kept candidates, numbered firstId, firstId + 1, ...
+    std::vector<GeneratedLevel> generate(int count, int firstId, const Options &options, Stats *stats) const;
+
+private:
+    uint64_t seed;
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "LevelPack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char PACK_MAGIC[4] = {'T', 'G', 'L', 'P'};
+static const uint32_t PACK_BYTE_ORDER = 0x01020304;
+
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t levelCount;
+};
+
+struct PackIndexEntry {
+    int32_t id;
+    uint32_t offset;
+    uint32_t bytes;
+    uint32_t reserved;
+};
+
+struct PackLevelHeader {
+    int32_t id;
+    float width, height;
+    float startX, startY;
+    float holeX, holeY;
+    float holeRadius;
+    uint32_t wallCount;
+    uint32_t waterCount;
+    uint32_t movingWaterCount;
+    LevelRating rating;
+    uint32_t reserved;
+};
+
+// The level arrays are stored exactly as these structs sit in memory
+static_assert(sizeof(WallDef) == 4 * sizeof(float), "WallDef must be four packed floats");
+static_assert(sizeof(MovingWaterDef) == 10 * sizeof(float), "MovingWaterDef must be ten packed floats");
+static_assert(sizeof(LevelRating) == 3 * sizeof(float), "LevelRating must be three packed floats");
+static_assert(sizeof(PackLevelHeader) == 60, "unexpected PackLevelHeader padding");
+
+// In 64 bits: size_t is 32 on the board, where huge counts from a bad file
+// could wrap around to a plausible size
+static uint64_t levelBytes(uint32_t walls, uint32_t water, uint32_t moving) {
+    return sizeof(PackLevelHeader) + (uint64_t(walls) + water) * sizeof(WallDef) + uint64_t(moving) * sizeof(MovingWaterDef);
+}
+
+LevelPack::LevelPack() : map(nullptr), size(0), levels(0), index(nullptr) {}
+
+LevelPack::~LevelPack() {
+    close();
+}
+
+bool LevelPack::open(const char *path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "LevelPack: cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(PackHeader))) {
+        std::cerr << "LevelPack: " << path << " is too short" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    void *m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive
+    ::close(fd);
+    if (m == MAP_FAILED) {
+        std::cerr << "LevelPack: mmap failed for " << path << std::endl;
+        size = 0;
+        return false;
+    }
+    map = static_cast<const uint8_t *>(m);
+
+    const PackHeader *header = reinterpret_cast<const PackHeader *>(map);
+    bool valid = std::memcmp(header->magic, PACK_MAGIC, 4) == 0 && header->version == VERSION &&
+                 header->byteOrder == PACK_BYTE_ORDER &&
+                 sizeof(PackHeader) + uint64_t(header->levelCount) * sizeof(PackIndexEntry) <= size;
+
+    // Check every index entry once so at() and find() can trust the file
+    const PackIndexEntry *entries = reinterpret_cast<const PackIndexEntry *>(map + sizeof(PackHeader));
+    for (uint32_t i = 0; valid && i < header->levelCount; ++i) {
+        const PackIndexEntry &e = entries[i];
+        valid = e.offset % 4 == 0 && e.bytes >= sizeof(PackLevelHeader) && e.offset <= size &&
+                e.bytes <= size - e.offset && (i == 0 || entries[i - 1].id < e.id);
+        if (valid) {
+            const PackLevelHeader *l = reinterpret_cast<const PackLevelHeader *>(map + e.offset);
+            valid = l->id == e.id && levelBytes(l->wallCount, l->waterCount, l->movingWaterCount) == e.bytes;
+        }
+    }
+    if (!valid) {
+        std::cerr << "LevelPack: " << path << " is not a valid version " << VERSION << " level pack" << std::endl;
+        close();
+        return false;
+    }
+    levels = header->levelCount;
+    index = reinterpret_cast<const uint8_t *>(entries);
+    return true;
+}
+
+void LevelPack::close() {
+    if (map)
+        munmap(const_cast<uint8_t *>(map), size);
+    map = nullptr;
+    size = 0;
+    levels = 0;
+    index = nullptr;
+}
+
+int LevelPack::idAt(int i) const {
+    if (i < 0 || i >= count())
+        return 0;
+    return reinterpret_cast<const PackIndexEntry *>(index)[i].id;
+}
+
+bool LevelPack::at(int i, LevelView &level) const {
+    if (i < 0 || i >= count())
+        return false;
+    const PackIndexEntry &e = reinterpret_cast<const PackIndexEntry *>(index)[i];
+    const PackLevelHeader *l = reinterpret_cast<const PackLevelHeader *>(map + e.offset);
+    const uint8_t *arrays = map + e.offset + sizeof(PackLevelHeader);
+
+    level.id = l->id;
+    level.width = l->width;
+    level.height = l->height;
+    level.ballStartPos.Set(l->startX, l->startY);
+    level.holePos.Set(l->holeX, l->holeY);
+    level.holeRadius = l->holeRadius;
+    level.walls = reinterpret_cast<const WallDef *>(arrays);
+    level.wallCount = static_cast<int>(l->wallCount);
+    level.water = level.walls + l->wallCount;
+    level.waterCount = static_cast<int>(l->waterCount);
+    level.movingWater = reinterpret_cast<const MovingWaterDef *>(level.water + l->waterCount);
+    level.movingWaterCount = static_cast<int>(l->movingWaterCount);
+    level.rating = l->rating;
+    return true;
+}
+
+bool LevelPack::find(int id, LevelView &level) const {
+    const PackIndexEntry *begin = reinterpret_cast<const PackIndexEntry *>(index);
+    const PackIndexEntry *end = begin + levels;
+    const PackIndexEntry *e = std::lower_bound(begin, end, id,
+                                               [](const PackIndexEntry &a, int key) { return a.id < key; });
+    if (e == end || e->id != id)
+        return false;
+    return at(static_cast<int>(e - begin), level);
+}
+
+bool LevelPack::write(const char *path, const std::vector<LevelConfig> &input) {
+    std::vector<const LevelConfig *> sorted;
+    for (const LevelConfig &level : input)
+        sorted.push_back(&level);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const LevelConfig *a, const LevelConfig *b) { return a->id < b->id; });
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i - 1]->id == sorted[i]->id) {
+            std::cerr << "LevelPack: level id " << sorted[i]->id << " appears twice" << std::endl;
+            return false;
+        }
+    }
+
+    PackHeader header;
+    std::memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = VERSION;
+    header.byteOrder = PACK_BYTE_ORDER;
+    header.levelCount = static_cast<uint32_t>(sorted.size());
+
+    std::vector<PackIndexEntry> entries(sorted.size());
+    std::vector<uint8_t> body;
+    size_t offset = sizeof(PackHeader) + entries.size() * sizeof(PackIndexEntry);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const LevelConfig &level = *sorted[i];
+        PackLevelHeader l;
+        std::memset(&l, 0, sizeof(l));
+        l.id = level.id;
+        l.width = level.width;
+        l.height = level.height;
+        l.startX = level.ballStartPos.x;
+        l.startY = level.ballStartPos.y;
+        l.holeX = level.holePos.x;
+        l.holeY = level.holePos.y;
+        l.holeRadius = level.holeRadius;
+        l.wallCount = static_cast<uint32_t>(level.walls.size());
+        l.waterCount = static_cast<uint32_t>(level.water.size());
+        l.movingWaterCount = static_cast<uint32_t>(level.movingWater.size());
+        l.rating = level.rating;
+
+        size_t bytes = static_cast<size_t>(levelBytes(l.wallCount, l.waterCount, l.movingWaterCount));
+        entries[i].id = level.id;
+        entries[i].offset = static_cast<uint32_t>(offset + body.size());
+        entries[i].bytes = static_cast<uint32_t>(bytes);
+        entries[i].reserved = 0;
+
+        size_t at = body.size();
+        body.resize(at + bytes);
+        uint8_t *p = body.data() + at;
+        std::memcpy(p, &l, sizeof(l));
+        p += sizeof(l);
+        std::memcpy(p, level.walls.data(), level.walls.size() * sizeof(WallDef));
+        p += level.walls.size() * sizeof(WallDef);
+        std::memcpy(p, level.water.data(), level.water.size() * sizeof(WallDef));
+        p += level.water.size() * sizeof(WallDef);
+        std::memcpy(p, level.movingWater.data(), level.movingWater.size() * sizeof(MovingWaterDef));
+    }
+
+    FILE *file = std::fopen(path, "wb");
+    if (!file) {
+        std::cerr << "LevelPack: cannot create " << path << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (entries.empty() || std::fwrite(entries.data(), sizeof(PackIndexEntry), entries.size(), file) == entries.size()) &&
+              (body.empty() || std::fwrite(body.data(), 1, body.size(), file) == body.size());
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok)
+        std::cerr << "LevelPack: failed writing " << path << std::endl;
+    return ok;
+}
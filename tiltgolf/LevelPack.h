@@ -0,0 +1,56 @@
+#ifndef LEVELPACK_H
+#define LEVELPACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "LevelData.h"
+
+// Compiled level pack, mapped read-only and used in place.
+//
+// Layout (host byte order, checked with a marker; x86 and the BeagleBone's
+// ARM are both little-endian IEEE):
+//   header  "TGLP", u32 version, u32 byteOrder (0x01020304), u32 levelCount
+//   index   per level, sorted by id: i32 id, u32 offset, u32 bytes, u32 0
+//   levels  at 4-byte aligned offsets:
+//           i32 id, f32 width, height, startX, startY, holeX, holeY, holeRadius,
+//           u32 wallCount, waterCount, movingWaterCount,
+//           f32 parSeconds, successRate, medianSeconds (LevelRating), u32 0,
+//           WallDef[wallCount], WallDef[waterCount], MovingWaterDef[movingWaterCount]
+//
+// The arrays have the in-memory layout of WallDef and MovingWaterDef, so a
+// LevelView points straight into the mapping; open() checks the index once
+// and nothing is parsed per level. Build packs with tools/levelc.
+class LevelPack {
+public:
+    static const uint32_t VERSION = 2;  // 2: LevelRating per level
+
+    LevelPack();
+    ~LevelPack();
+
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return map != nullptr; }
+
+    int count() const { return static_cast<int>(levels); }
+    int idAt(int index) const;
+
+    // Views stay valid until close()
+    bool at(int index, LevelView &level) const;
+    bool find(int id, LevelView &level) const;
+
+    // Write levels as a pack; ids must be unique
+    static bool write(const char *path, const std::vector<LevelConfig> &levels);
+
+private:
+    LevelPack(const LevelPack &);
+    LevelPack &operator=(const LevelPack &);
+
+    const uint8_t *map;
+    size_t size;
+    uint32_t levels;
+    const uint8_t *index;
+};
+
+#endif
@@ -26,6 +26,12 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
 	menu->setUnlockStates(unlockedLevels);
 	game->setTotalLevels(static_cast<int>(unlockedLevels.size()));
 
+	// Par under each level, from the pack or the built-in ratings
+	std::vector<LevelRating> ratings;
+	for (int id = 1; id <= static_cast<int>(unlockedLevels.size()); ++id)
+		ratings.push_back(game->levelRating(id));
+	menu->setRatings(ratings);
+
 	// Connect screen signals to main window slots
 	connect(menu, &MenuScreen::levelSelected, this, &MainWindow::startLevel);
 	connect(game, &GameScreen::exitToMenu, this, &MainWindow::returnToMenu);
@@ -81,6 +81,11 @@ void MenuScreen::setFreePlayMode(bool enabled) {
 	refreshLevelButtons();
 }
 
+void MenuScreen::setRatings(const std::vector<LevelRating>& levelRatings) {
+	ratings = levelRatings;
+	refreshLevelButtons();
+}
+
 void MenuScreen::refreshLevelButtons() {
 	QString unlockedStyle = "background-color: yellow; color: white; font-size: 18px; font-weight: bold;";
 	QString lockedStyle = "background-color: black; color: red; font-size: 18px; font-weight: bold; border: 2px solid red;";
@@ -98,9 +103,18 @@ void MenuScreen::refreshLevelButtons() {
 		QPushButton *btn = levelButtons[i];
 		if (isUnlocked) {
 			btn->setEnabled(true);
-			btn->setText(QString("%1").arg(i + 1));
 			btn->setStyleSheet(unlockedStyle);
-			btn->setToolTip("Play level");
+			if (i < static_cast<int>(ratings.size()) && ratings[i].parSeconds > 0.0f) {
+				const LevelRating &r = ratings[i];
+				btn->setText(QString("%1\nPar %2 s").arg(i + 1).arg(r.parSeconds, 0, 'f', 0));
+				btn->setToolTip(QString("Play level - par %1 s, %2% clean finishes, median %3 s")
+				                    .arg(r.parSeconds, 0, 'f', 0)
+				                    .arg(100.0f * r.successRate, 0, 'f', 0)
+				                    .arg(r.medianSeconds, 0, 'f', 0));
+			} else {
+				btn->setText(QString("%1").arg(i + 1));
+				btn->setToolTip("Play level");
+			}
 		} else {
 			btn->setEnabled(false);
 			btn->setText("X");
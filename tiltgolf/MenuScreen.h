@@ -10,11 +10,15 @@
 #include <QVector>
 #include <vector>
 
+#include "LevelData.h"
+
 class MenuScreen: public QWidget {
 	Q_OBJECT
 public:
 	MenuScreen(QWidget *parent = nullptr);
 	void setUnlockStates(const std::vector<bool>& states);
+	// Par shown under each level number, in level order
+	void setRatings(const std::vector<LevelRating>& levelRatings);
 	bool isFreePlayMode() const { return freePlayMode; }
 	int levelCount() const { return levelButtons.size(); }
 
@@ -30,6 +34,7 @@ private:
 	QPushButton *freePlayButton;
 	QVector<QPushButton*> levelButtons;
 	std::vector<bool> unlockedLevels;
+	std::vector<LevelRating> ratings;
 	bool freePlayMode = false;
 
 	void refreshLevelButtons();
@@ -1,10 +1,30 @@
 #include "PhysicsEngine.h"
+#include "LevelCache.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "Rewind.h"
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+// std::min takes it by reference, so unoptimised builds need the definition
+const int PhysicsEngine::MAX_SUBSTEPS;
+
+PhysicsEngine::PhysicsEngine(bool useIMU) : levelArena(LEVEL_ARENA_BYTES), world(nullptr), ballBody(nullptr),
+                                             activeTemplate(nullptr) {
+    // A tick may take several Box2D steps; advance() clears once per tick
+    contactEvents.SetAutoClear(false);
 
-PhysicsEngine::PhysicsEngine() : world(nullptr), ballBody(nullptr) {
     // Initialize IMU
-    if (!imu.begin()) {
+    if (!useIMU) {
+        // Once per process: batches and generators create many engines
+        static std::atomic<bool> announced(false);
+        if (!announced.exchange(true))
+            std::cout << "PhysicsEngine: running without IMU." << std::endl;
+    } else if (!imu.begin()) {
         std::cerr << "PhysicsEngine: Failed to initialize IMU!" << std::endl;
     } else {
         std::cout << "PhysicsEngine: IMU Initialized." << std::endl;
@@ -12,24 +32,104 @@ PhysicsEngine::PhysicsEngine() : world(nullptr), ballBody(nullptr) {
 }
 
 PhysicsEngine::~PhysicsEngine() {
-    if (world) delete world;
+    recordCheckpoint();
+    releaseWorld();
 }
 
 void PhysicsEngine::loadLevel(const LevelConfig& level) {
-    if (world) delete world;
-
+    beginLevel(level.id);
     currentLevel = level;
+    buildLevel();
+}
+
+void PhysicsEngine::loadLevel(const LevelView& level) {
+    beginLevel(level.id);
+    if (!levelCache) {
+        LevelData::assign(currentLevel, level);
+        buildLevel();
+        return;
+    }
+
+    // Hand back the current template first; it may be the one asked for
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    releaseWorld();
+    LevelTemplate *cached = levelCache->acquire(level);
+    if (cached) {
+        activateTemplate(cached);
+    } else {
+        LevelData::assign(currentLevel, level);
+        buildLevel();
+    }
+    levelCache->recordLoad(cached != nullptr, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                  std::chrono::steady_clock::now() - start).count());
+}
+
+void PhysicsEngine::setLevelCache(LevelCache *cache) {
+    levelCache = cache;
+}
+
+void PhysicsEngine::beginLevel(int levelId) {
+    recordCheckpoint();
+    if (recorder) {
+        recorder->recordLevel(levelId);
+        recorder->recordStepping(adaptiveStepping);
+        recorder->recordTickRate(tickRate);
+    }
+}
+
+void PhysicsEngine::releaseWorld() {
+    if (activeTemplate) {
+        world->SetContactEvents(nullptr);
+        templateOwner->release(activeTemplate);
+        activeTemplate = nullptr;
+        templateOwner = nullptr;
+    } else if (world) {
+        delete world;
+        // The old world is gone, so all of its bodies/fixtures/contacts go at once
+        levelArena.Reset();
+    }
+    world = nullptr;
+    ballBody = nullptr;
+}
 
+void PhysicsEngine::buildLevel() {
+    releaseWorld();
+    world = createWorld(currentLevel, levelArena, &ballBody, &thinnestWall);
+    world->SetContactEvents(&contactEvents);
+    finishLevel();
+}
+
+void PhysicsEngine::activateTemplate(LevelTemplate *level) {
+    releaseWorld();
+    activeTemplate = level;
+    templateOwner = levelCache;
+    world = level->world;
+    ballBody = level->ball;
+    thinnestWall = level->thinnestWall;
+    currentLevel = level->level;
+    // Back to the freshly built state, whatever the last borrower did
+    world->RestoreState(level->startState.data(), static_cast<int32>(level->startState.size()));
+    world->SetContactEvents(&contactEvents);
+    finishLevel();
+}
+
+b2World* PhysicsEngine::createWorld(const LevelConfig& level, b2ArenaAllocator& arena, b2Body** ball,
+                                    float* thinnestWall) {
     // Zero gravity because we are looking down at the table
     // Gravity/Force is applied manually via IMU
     b2Vec2 gravity(0.0f, 0.0f);
-    world = new b2World(gravity);
+    b2WorldMemoryDef memoryDef;
+    memoryDef.arena = &arena;
+    memoryDef.stackSize = STEP_STACK_BYTES;
+    b2World* world = new b2World(gravity, memoryDef);
 
     // 1. Create Walls (uniform restitution)
     b2BodyDef wallDef;
     wallDef.type = b2_staticBody;
     
+    *thinnestWall = 1.0f;
     for (const auto& w : level.walls) {
+        *thinnestWall = std::min(*thinnestWall, 2.0f * std::min(w.size.x, w.size.y));
         wallDef.position = w.position;
         b2Body* wall = world->CreateBody(&wallDef);
         
@@ -51,10 +151,10 @@ void PhysicsEngine::loadLevel(const LevelConfig& level) {
     ballDef.linearDamping = 0.8f; // Friction/Air resistance
     ballDef.angularDamping = 0.8f;
     
-    ballBody = world->CreateBody(&ballDef);
+    b2Body* ballBody = world->CreateBody(&ballDef);
 
     b2CircleShape circle;
-    circle.m_radius = 0.5f; // 0.5m radius
+    circle.m_radius = BALL_RADIUS;
 
     b2FixtureDef fixtureDef;
     fixtureDef.shape = &circle;
@@ -63,17 +163,112 @@ void PhysicsEngine::loadLevel(const LevelConfig& level) {
     fixtureDef.restitution = 0.6f; // Bounciness
 
     ballBody->CreateFixture(&fixtureDef);
+    *ball = ballBody;
+    return world;
+}
 
+void PhysicsEngine::finishLevel() {
     // Reset previous filter
     prev_fx = prev_fy = 0.0f;
+    // The last tick's events point into the old world
+    contactEvents.Clear();
+
+    // Keep the fresh level so reset() does not need a rebuild
+    levelStartState.resize(stateSize());
+    saveState(levelStartState.data(), static_cast<int32>(levelStartState.size()));
+
+    if (history) history->begin(*this);
 }
 
 void PhysicsEngine::reset() {
+    if (recorder) recorder->recordReset();
+    if (restoreState(levelStartState.data(), static_cast<int32>(levelStartState.size())))
+        respawnCount++;
+    else
+        respawnBall();
+    if (history) history->begin(*this);
+}
+
+// Engine part of a snapshot; the moving water states and the world follow
+struct PhysicsEngineState {
+    int32 levelId;
+    int32 movingWaterCount;
+    float prev_fx, prev_fy;
+    int16_t lastInputX, lastInputY;
+    int32 worldBytes;
+};
+
+struct MovingWaterState {
+    b2Vec2 position;
+    float phase;
+    float padding;
+};
+
+int32 PhysicsEngine::stateSize() const {
+    if (!world) return 0;
+    return static_cast<int32>(sizeof(PhysicsEngineState) + currentLevel.movingWater.size() * sizeof(MovingWaterState)) +
+           world->GetStateSize();
+}
+
+int32 PhysicsEngine::saveState(void *buffer, int32 capacity) const {
+    if (!world || stateSize() > capacity) return 0;
+
+    uint8_t *p = static_cast<uint8_t *>(buffer);
+    PhysicsEngineState *state = reinterpret_cast<PhysicsEngineState *>(p);
+    state->levelId = currentLevel.id;
+    state->movingWaterCount = static_cast<int32>(currentLevel.movingWater.size());
+    state->prev_fx = prev_fx;
+    state->prev_fy = prev_fy;
+    state->lastInputX = lastInputX;
+    state->lastInputY = lastInputY;
+    p += sizeof(PhysicsEngineState);
+
+    MovingWaterState *water = reinterpret_cast<MovingWaterState *>(p);
+    for (const auto &mw : currentLevel.movingWater) {
+        water->position = mw.position;
+        water->phase = mw.phase;
+        water->padding = 0.0f;
+        ++water;
+    }
+    p = reinterpret_cast<uint8_t *>(water);
+
+    int32 header = static_cast<int32>(p - static_cast<uint8_t *>(buffer));
+    state->worldBytes = world->SaveState(p, capacity - header);
+    return state->worldBytes > 0 ? header + state->worldBytes : 0;
+}
+
+bool PhysicsEngine::restoreState(const void *buffer, int32 size) {
+    if (!world || size < static_cast<int32>(sizeof(PhysicsEngineState))) return false;
+
+    const uint8_t *p = static_cast<const uint8_t *>(buffer);
+    const PhysicsEngineState *state = reinterpret_cast<const PhysicsEngineState *>(p);
+    int32 header = static_cast<int32>(sizeof(PhysicsEngineState) + state->movingWaterCount * sizeof(MovingWaterState));
+    if (state->levelId != currentLevel.id ||
+        state->movingWaterCount != static_cast<int32>(currentLevel.movingWater.size()) ||
+        header + state->worldBytes != size ||
+        !world->RestoreState(p + header, state->worldBytes))
+        return false;
+
+    prev_fx = state->prev_fx;
+    prev_fy = state->prev_fy;
+    lastInputX = state->lastInputX;
+    lastInputY = state->lastInputY;
+    const MovingWaterState *water = reinterpret_cast<const MovingWaterState *>(p + sizeof(PhysicsEngineState));
+    for (auto &mw : currentLevel.movingWater) {
+        mw.position = water->position;
+        mw.phase = water->phase;
+        ++water;
+    }
+    return true;
+}
+
+void PhysicsEngine::respawnBall() {
     if (ballBody) {
         ballBody->SetTransform(currentLevel.ballStartPos, 0.0f);
         ballBody->SetLinearVelocity(b2Vec2(0,0));
         ballBody->SetAngularVelocity(0);
         ballBody->SetAwake(true);
+        respawnCount++;
 
         // reset smoothing state so the ball responds immediately after reset
         prev_fx = prev_fy = 0.0f;
@@ -85,10 +280,33 @@ void PhysicsEngine::step() {
 
     // 1. Read IMU
     imu.update();
+    stepPolled();
+}
+
+void PhysicsEngine::stepPolled() {
+    if (!world || !ballBody) return;
+
+    if (recorder)
+        recorder->recordTick(imu.getRawX(), imu.getRawY(), imu.getBiasX(), imu.getBiasY());
 
     // 2. Read calibrated sensor values (raw - bias)
-    float sx = static_cast<float>(imu.getX());
-    float sy = static_cast<float>(imu.getY());
+    advance(imu.getX(), imu.getY());
+    if (history) history->capture(*this);
+}
+
+void PhysicsEngine::stepWithInput(int16_t inputX, int16_t inputY) {
+    if (!world || !ballBody) return;
+
+    // Already calibrated, so it is logged as a raw sample with zero bias
+    if (recorder)
+        recorder->recordTick(inputX, inputY, 0, 0);
+    advance(inputX, inputY);
+    if (history) history->capture(*this);
+}
+
+b2Vec2 PhysicsEngine::tiltForce(int16_t inputX, int16_t inputY) const {
+    float sx = static_cast<float>(inputX);
+    float sy = static_cast<float>(inputY);
 
     // 3. Axis swap if needed (depends on board mounting)
     float sensorX = swapXY ? sy : sx;
@@ -102,8 +320,84 @@ void PhysicsEngine::step() {
 
     // 5. Convert sensor reading into world force applying global scaling
     //    (k_Force chosen in header tunables)
-    float raw_fx = sensorX * k_Force;
-    float raw_fy = sensorY * k_Force;
+    return b2Vec2(sensorX * k_Force, sensorY * k_Force);
+}
+
+void PhysicsEngine::forceToInput(const b2Vec2& force, int16_t& inputX, int16_t& inputY) const {
+    // Undo 5. scaling, 4. sign inversion and 3. axis swap
+    float sensorX = force.x / k_Force;
+    float sensorY = force.y / k_Force;
+    if (invertX)
+        sensorX = -sensorX;
+    if (invertY)
+        sensorY = -sensorY;
+    float sx = swapXY ? sensorY : sensorX;
+    float sy = swapXY ? sensorX : sensorY;
+
+    auto toInput = [](float v) {
+        v = std::round(std::max(-32768.0f, std::min(32767.0f, v)));
+        return static_cast<int16_t>(v);
+    };
+    inputX = toInput(sx);
+    inputY = toInput(sy);
+}
+
+bool PhysicsEngine::tiltWakes(int16_t inputX, int16_t inputY) const {
+    b2Vec2 raw = tiltForce(inputX, inputY);
+    return std::fabs(raw.x) >= deadzone || std::fabs(raw.y) >= deadzone;
+}
+
+bool PhysicsEngine::isAtRest() const {
+    // A sleeping ball means the filter has output exactly zero for a while
+    // (any applied force wakes it); checking it keeps idle ticks equivalent
+    // to stepping with zero tilt
+    return ballBody && !ballBody->IsAwake() && prev_fx == 0.0f && prev_fy == 0.0f &&
+           currentLevel.movingWater.empty();
+}
+
+bool PhysicsEngine::pollTilt() {
+    imu.update();
+    return tiltWakes(imu.getX(), imu.getY());
+}
+
+// Earliest fraction t of the segment from -> to (relative to a box centred on
+// the origin) that lies inside the box, edges included. A bounce within the
+// tick is approximated by the straight segment.
+static bool sweepIntoBox(const b2Vec2 &from, const b2Vec2 &to, const b2Vec2 &half, float &entry) {
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    const float p[2] = {from.x, from.y};
+    const float d[2] = {to.x - from.x, to.y - from.y};
+    const float h[2] = {half.x, half.y};
+    for (int i = 0; i < 2; ++i) {
+        if (d[i] == 0.0f) {
+            if (p[i] < -h[i] || p[i] > h[i])
+                return false;
+            continue;
+        }
+        float t1 = (-h[i] - p[i]) / d[i];
+        float t2 = (h[i] - p[i]) / d[i];
+        if (t1 > t2)
+            std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax)
+            return false;
+    }
+    entry = tMin;
+    return true;
+}
+
+void PhysicsEngine::advance(int16_t inputX, int16_t inputY) {
+    PROFILE_ZONE("PhysicsEngine::step");
+
+    lastInputX = inputX;
+    lastInputY = inputY;
+
+    // 3.-5. Axis mapping and scaling to a world force
+    b2Vec2 raw = tiltForce(inputX, inputY);
+    float raw_fx = raw.x;
+    float raw_fy = raw.y;
 
     // 6. Deadzone to avoid tiny jitter
     if (std::fabs(raw_fx) < deadzone)
@@ -114,47 +408,99 @@ void PhysicsEngine::step() {
     // 7. Simple low-pass filter (IIR): smoothed = prev + alpha*(raw - prev)
     float fx = prev_fx + smoothAlpha * (raw_fx - prev_fx);
     float fy = prev_fy + smoothAlpha * (raw_fy - prev_fy);
+    if (raw_fx == 0.0f && std::fabs(fx) < FILTER_REST)
+        fx = 0.0f;
+    if (raw_fy == 0.0f && std::fabs(fy) < FILTER_REST)
+        fy = 0.0f;
     prev_fx = fx;
     prev_fy = fy;
 
-    // 8. Apply Force to center of ball
+    b2Vec2 start = ballBody->GetPosition();
+    hazardEntry = -1.0f;
+    contactEvents.Clear();
+
+    // 8. Apply Force to center of ball and 9. step Box2D
     //    Note: positive fx moves ball in +X (right) direction; positive fy moves ball in +Y (down)
-    ballBody->ApplyForceToCenter(b2Vec2(fx, fy), true);
+    if (adaptiveStepping) {
+        stepAdaptive(b2Vec2(fx, fy));
+    } else {
+        // No tilt must not wake a sleeping ball, or it never stays asleep
+        ballBody->ApplyForceToCenter(b2Vec2(fx, fy), fx != 0.0f || fy != 0.0f);
+        world->Step(timeStep, VELOCITY_ITERATIONS, POSITION_ITERATIONS);
+        lastSubsteps = 1;
+    }
 
-    // 9. Step Box2D
-    world->Step(TIME_STEP, VELOCITY_ITERATIONS, POSITION_ITERATIONS);
+    // 10. Update moving water positions (level 3) and 11. water hazards.
+    //     The ball's centre is swept from its old to its new position (relative
+    //     to the water for moving blocks), so a fast ball cannot pass through a
+    //     strip thinner than one tick of travel. The earliest entry counts.
+    b2Vec2 end = ballBody->GetPosition();
+    float entry = 2.0f;
+    for (auto &mw : currentLevel.movingWater) {
+        b2Vec2 before = mw.position;
+        mw.phase += mw.speed * timeStep;
+        float offset = mw.amplitude * b2Sin(mw.phase) * (mw.direction >= 0.0f ? 1.0f : -1.0f);
+        mw.position = b2Vec2(mw.basePosition.x, mw.basePosition.y + offset);
+
+        float t;
+        if (sweepIntoBox(start - before, end - mw.position, mw.size, t) && t < entry)
+            entry = t;
+    }
+    for (const auto &w : currentLevel.water) {
+        float t;
+        if (sweepIntoBox(start - w.position, end - w.position, w.size, t) && t < entry)
+            entry = t;
+    }
 
-    // 10. Update moving water positions (level 3)
-    if (!currentLevel.movingWater.empty()) {
-        for (auto &mw : currentLevel.movingWater) {
-            mw.phase += mw.speed * TIME_STEP;
-            float offset = mw.amplitude * std::sin(mw.phase) * (mw.direction >= 0.0f ? 1.0f : -1.0f);
-            mw.position = b2Vec2(mw.basePosition.x, mw.basePosition.y + offset);
-        }
+    if (entry <= 1.0f) {
+        hazardEntry = entry;
+        hazardEntryPoint = start + entry * (end - start);
+        respawnBall();
     }
+}
 
-    // 11. Water hazards: check after step. If ball center is inside any water rect (static or moving), reset.
-    b2Vec2 pos = ballBody->GetPosition();
-    auto inside = [&](float cx, float cy, float hx, float hy) {
-        float minX = cx - hx;
-        float maxX = cx + hx;
-        float minY = cy - hy;
-        float maxY = cy + hy;
-        return (pos.x >= minX && pos.x <= maxX && pos.y >= minY && pos.y <= maxY);
-    };
+void PhysicsEngine::stepAdaptive(const b2Vec2 &force) {
+    // A still ball with no real tilt may sleep; then nothing in the world moves
+    bool pushing = force.LengthSquared() > WAKE_FORCE * WAKE_FORCE;
+    if (!pushing && !ballBody->IsAwake()) {
+        lastSubsteps = 0;
+        return;
+    }
 
-    for (const auto &w : currentLevel.water) {
-        if (inside(w.position.x, w.position.y, w.size.x, w.size.y)) {
-            reset();
-            return;
-        }
+    // Never let the ball move further than the thinnest wall in one substep, so
+    // the regular contact solver sees every wall it could hit. Box2D's TOI pass
+    // remains as a backstop above MAX_SUBSTEPS.
+    float travel = ballBody->GetLinearVelocity().Length() * timeStep;
+    int substeps = static_cast<int>(std::ceil(travel / thinnestWall));
+    substeps = std::max(1, std::min(substeps, MAX_SUBSTEPS));
+
+    bool slow = travel < SLOW_TRAVEL;
+    int32 velocityIterations = slow ? SLOW_VELOCITY_ITERATIONS : VELOCITY_ITERATIONS;
+    int32 positionIterations = slow ? SLOW_POSITION_ITERATIONS : POSITION_ITERATIONS;
+    float dt = timeStep / substeps;
+
+    for (int i = 0; i < substeps; ++i) {
+        // Forces are cleared after every Box2D step
+        if (pushing)
+            ballBody->ApplyForceToCenter(force, true);
+        world->Step(dt, velocityIterations, positionIterations);
     }
-    for (const auto &mw : currentLevel.movingWater) {
-        if (inside(mw.position.x, mw.position.y, mw.size.x, mw.size.y)) {
-            reset();
-            return;
-        }
+    lastSubsteps = substeps;
+}
+
+void PhysicsEngine::setAdaptiveStepping(bool enabled) {
+    adaptiveStepping = enabled;
+    if (recorder) recorder->recordStepping(enabled);
+}
+
+void PhysicsEngine::setTickRate(int ticksPerSecond) {
+    if (ticksPerSecond <= 0) {
+        std::cerr << "PhysicsEngine: ignoring tick rate " << ticksPerSecond << std::endl;
+        return;
     }
+    tickRate = ticksPerSecond;
+    timeStep = 1.0f / ticksPerSecond;
+    if (recorder) recorder->recordTickRate(ticksPerSecond);
 }
 
 b2Vec2 PhysicsEngine::getBallPosition() const {
@@ -162,15 +508,48 @@ b2Vec2 PhysicsEngine::getBallPosition() const {
     return b2Vec2(0,0);
 }
 
+b2Vec2 PhysicsEngine::getBallVelocity() const {
+    if (ballBody) return ballBody->GetLinearVelocity();
+    return b2Vec2(0,0);
+}
+
+float PhysicsEngine::getBallMass() const {
+    if (ballBody) return ballBody->GetMass();
+    return 0.0f;
+}
+
+bool PhysicsEngine::isBallInHole() const {
+    if (!ballBody) return false;
+    // Tolerance of half the radius: the ball has to roll well into the cup
+    b2Vec2 distVec = ballBody->GetPosition() - currentLevel.holePos;
+    return distVec.Length() < currentLevel.holeRadius * 0.5f;
+}
+
 float PhysicsEngine::getBallAngle() const {
     if (ballBody) return ballBody->GetAngle();
     return 0.0f;
 }
 
-LevelConfig PhysicsEngine::getLevelConfig() const {
+const LevelConfig& PhysicsEngine::getLevelConfig() const {
     return currentLevel;
 }
 
+void PhysicsEngine::getStateHash(b2WorldHash *hash) const {
+    if (world) {
+        world->GetStateHash(hash);
+    } else {
+        memset(hash, 0, sizeof(*hash));
+    }
+}
+
+void PhysicsEngine::getMemoryStats(b2BlockAllocatorStats* stats) const {
+    if (world) {
+        world->GetMemoryStats(stats);
+    } else {
+        memset(stats, 0, sizeof(*stats));
+    }
+}
+
 bool PhysicsEngine::calibrateIMU()
 {
     // Ask IMU to treat current reading as saved bias (in-memory)
@@ -194,10 +573,7 @@ void PhysicsEngine::startCalibrationPreview(bool resetBallToStart)
     if (resetBallToStart && ballBody)
     {
         // Move ball to start position and stop motion so user can align easily
-        ballBody->SetTransform(currentLevel.ballStartPos, 0.0f);
-        ballBody->SetLinearVelocity(b2Vec2(0, 0));
-        ballBody->SetAngularVelocity(0);
-        ballBody->SetAwake(true);
+        setBallPosition(currentLevel.ballStartPos, 0.0f);
     }
 
     std::cout << "PhysicsEngine: Calibration preview started." << std::endl;
@@ -228,8 +604,42 @@ void PhysicsEngine::setBallPosition(const b2Vec2 &pos, float angle)
 {
     if (!ballBody)
         return;
+    if (recorder)
+        recorder->recordBallPosition(pos.x, pos.y, angle);
     ballBody->SetTransform(pos, angle);
     ballBody->SetLinearVelocity(b2Vec2(0, 0));
     ballBody->SetAngularVelocity(0);
     ballBody->SetAwake(true);
-}
\ No newline at end of file
+    if (history) history->begin(*this);
+}
+
+void PhysicsEngine::setRecorder(InputRecorder *newRecorder)
+{
+    // Close the old log with the final ball state
+    recordCheckpoint();
+    recorder = newRecorder;
+}
+
+void PhysicsEngine::setRewindBuffer(RewindBuffer *newHistory)
+{
+    history = newHistory;
+    if (history && world)
+        history->begin(*this);
+}
+
+bool PhysicsEngine::rewind(int ticks)
+{
+    if (!history || !history->rewind(*this, ticks))
+        return false;
+    if (recorder)
+        recorder->recordRewind(ticks);
+    return true;
+}
+
+void PhysicsEngine::recordCheckpoint()
+{
+    if (!recorder || !ballBody)
+        return;
+    b2Vec2 pos = ballBody->GetPosition();
+    recorder->recordCheckpoint(pos.x, pos.y, ballBody->GetAngle());
+}
@@ -5,17 +5,38 @@
 #include "IMU.h"
 #include "LevelData.h"
 
+#include <vector>
+
+class InputRecorder;
+class LevelCache;
+class RewindBuffer;
+struct LevelTemplate;
+
 class PhysicsEngine {
 public:
-    PhysicsEngine();
+    // useIMU = false skips opening the I2C sensor (headless runs, replays)
+    explicit PhysicsEngine(bool useIMU = true);
     ~PhysicsEngine();
 
     // Initialize the Box2D world with the given level
     void loadLevel(const LevelConfig& level);
+    // Same from a level pack or other contiguous data; the arrays are copied
+    // into the engine's LevelConfig. With a level cache attached, a prebuilt
+    // world for the level is borrowed instead of building one.
+    void loadLevel(const LevelView& level);
+
+    // Prebuilt level worlds (see LevelCache.h), owned by the caller, who
+    // keeps it alive as long as this engine. Pass nullptr to stop; the
+    // current level keeps its world until the next load.
+    void setLevelCache(LevelCache *cache);
 
     // Advance the simulation by one time step
     void step();
 
+    // Same as step() but with calibrated sensor values supplied by the caller
+    // instead of read from the IMU (headless runs, scripted input)
+    void stepWithInput(int16_t inputX, int16_t inputY);
+
     // Simple IMU calibrate wrapper (permanent/in-memory)
     bool calibrateIMU();
 
@@ -29,16 +50,117 @@ public:
 
     // Getters for game logic
     b2Vec2 getBallPosition() const;
+    b2Vec2 getBallVelocity() const;
+    float getBallMass() const;
     float getBallAngle() const;
-    LevelConfig getLevelConfig() const;
+    const LevelConfig& getLevelConfig() const;
+    // Ball centre within half the hole radius: the level is won
+    bool isBallInHole() const;
+
+    // Calibrated sensor values that map to this world force before the
+    // deadzone and filter; the inverse of steps 3-5 of step(), rounded and
+    // clamped to int16 (synthetic tilt for bots and tests)
+    void forceToInput(const b2Vec2& force, int16_t& inputX, int16_t& inputY) const;
+
+    // Ball asleep with no force left in the input filter and no moving water:
+    // step() would change nothing until the tilt does
+    bool isAtRest() const;
+    // Whether this calibrated tilt gives a force outside the deadzone
+    bool tiltWakes(int16_t inputX, int16_t inputY) const;
+    // Read the IMU without stepping (idle loop); true if the tilt would move
+    // the ball. Samples read here are not recorded unless stepped.
+    bool pollTilt();
+    // step() with the sample pollTilt() just read: one bus read per waking
+    // tick, and the sample that woke the ball is the one stepped and recorded
+    void stepPolled();
+
+    // Calibrated tilt used by the last step
+    int16_t getLastInputX() const { return lastInputX; }
+    int16_t getLastInputY() const { return lastInputY; }
+    // Times the ball went back to the start (water hazards and reset())
+    uint32_t getRespawnCount() const { return respawnCount; }
+
+    // Contact begin/end/hit events recorded during the last step (all of its
+    // substeps; none on a tick the sleeping ball skipped)
+    const b2ContactEvents& getContactEvents() const { return contactEvents; }
+
+    // Memory use of the current world (per size class) and of the level arena
+    void getMemoryStats(b2BlockAllocatorStats* stats) const;
+    const b2ArenaAllocator& getLevelArena() const { return levelArena; }
     
-    // Reset ball to start
+    // Restore the whole level to the state right after loadLevel()
     void reset();
 
+    // Snapshot of all mutable simulation state (Box2D world, moving water,
+    // input filter) for instant restore. Only valid for the current level.
+    // stateSize() changes with the number of contacts; leave headroom.
+    int32 stateSize() const;
+    // Returns bytes written, or 0 if the buffer is too small. The buffer must
+    // be 8-byte aligned.
+    int32 saveState(void *buffer, int32 capacity) const;
+    bool restoreState(const void *buffer, int32 size);
+
+    // Per-category hash of the world (bodies, contacts, sleep) for comparing
+    // runs across machines; zeroes without a level
+    void getStateHash(b2WorldHash *hash) const;
+
+    // Log every level load, IMU sample, bias change and ball reset/placement
+    // so the run can be replayed exactly (see Replay.h). Attach before
+    // loadLevel() since a log must start with a level. Pass nullptr to stop;
+    // the recorder is owned by the caller.
+    void setRecorder(InputRecorder *recorder);
+
+    // Adaptive stepping: substeps scale with how far the ball moves per tick
+    // relative to the thinnest wall, iterations drop when it is slow, and the
+    // world is not stepped at all while the ball sleeps. Off by default.
+    void setAdaptiveStepping(bool enabled);
+    bool isAdaptiveStepping() const { return adaptiveStepping; }
+    // Box2D steps taken by the last tick (1 in fixed mode, 0 while asleep)
+    int getLastSubsteps() const { return lastSubsteps; }
+
+    // Ticks per second that step() simulates (60 by default); the caller's
+    // timer has to match. Water hazards are tested along the ball's path over
+    // the whole tick, so 30 Hz cannot skip a thin strip.
+    void setTickRate(int ticksPerSecond);
+    int getTickRate() const { return tickRate; }
+
+    // Where in the last tick the ball entered water: fraction 0..1 of the
+    // tick, or -1 if it did not. The point is on the ball's path, before
+    // the respawn moved it back to the start.
+    float getHazardEntry() const { return hazardEntry; }
+    b2Vec2 getHazardEntryPoint() const { return hazardEntryPoint; }
+
+    // Keep recent ticks for rewind (see Rewind.h). The buffer is restarted on
+    // loadLevel(), reset() and setBallPosition(). Owned by the caller; pass
+    // nullptr to stop.
+    void setRewindBuffer(RewindBuffer *history);
+    // Put the whole simulation back `ticks` steps. Returns false if the
+    // history does not reach that far (or no buffer is attached).
+    bool rewind(int ticks);
+
 private:
+    friend class LevelCache;
+    friend class Prediction;
+    friend class RewindBuffer;
+
+    // Backs the world's small object memory for one level; reset on loadLevel.
+    // Enough for the built-in levels; larger ones spill over to the heap.
+    static const int32 LEVEL_ARENA_BYTES = 128 * 1024;
+    b2ArenaAllocator levelArena;
+
+    // Per-step solver scratch. The built-in levels peak under 3 KB; Box2D
+    // grows it between steps if a bigger level gets close to the limit.
+    static const int32 STEP_STACK_BYTES = 8 * 1024;
+
     b2World* world;
     b2Body* ballBody;
+    // World borrowed from the level cache instead of built in levelArena
+    LevelTemplate* activeTemplate;
     IMU imu;
+
+    // Flat per-tick contact event buffers (replaces a b2ContactListener),
+    // cleared by advance() rather than by every Box2D step
+    b2ContactEvents contactEvents;
     
     LevelConfig currentLevel;
 
@@ -54,13 +176,69 @@ private:
 
     const float deadzone = 0.02f;
     const float smoothAlpha = 0.25f;
+    // With no tilt the filter decays geometrically and would stall on the
+    // smallest denormal, keeping the ball awake forever; snap it to zero here
+    const float FILTER_REST = 1.0e-6f;
 
-    const float TIME_STEP = 1.0f / 60.0f;
+    static const int DEFAULT_TICK_RATE = 60;
+    int tickRate = DEFAULT_TICK_RATE;
+    float timeStep = 1.0f / DEFAULT_TICK_RATE;
     const int32 VELOCITY_ITERATIONS = 6;
     const int32 POSITION_ITERATIONS = 2;
 
+    // Adaptive stepping tunables
+    static const int MAX_SUBSTEPS = 8;          // beyond this Box2D's TOI solver still catches the ball
+    const float SLOW_TRAVEL = 0.02f;            // metres per tick (1.2 m/s) counted as slow
+    const int32 SLOW_VELOCITY_ITERATIONS = 3;
+    const int32 SLOW_POSITION_ITERATIONS = 1;
+    const float WAKE_FORCE = 1.0e-3f;           // smaller tilt forces let the ball fall asleep
+
+    bool adaptiveStepping = false;
+    int lastSubsteps = 0;
+    float thinnestWall = 1.0f;                  // full thickness in metres, from loadLevel()
+
+    float hazardEntry = -1.0f;
+    b2Vec2 hazardEntryPoint = b2Vec2(0.0f, 0.0f);
+
     float prev_fx = 0.0f;
     float prev_fy = 0.0f;
+
+    int16_t lastInputX = 0;
+    int16_t lastInputY = 0;
+    uint32_t respawnCount = 0;
+
+    // Taken at the end of loadLevel(); reset() restores it
+    std::vector<uint8_t> levelStartState;
+
+    InputRecorder *recorder = nullptr;
+    RewindBuffer *history = nullptr;
+    LevelCache *levelCache = nullptr;
+    LevelCache *templateOwner = nullptr;
+
+    // Sensor axes to world force, before the deadzone and filter
+    b2Vec2 tiltForce(int16_t inputX, int16_t inputY) const;
+    // Log the load, then build the world from currentLevel or take it from
+    // a cached template
+    void beginLevel(int levelId);
+    void buildLevel();
+    void activateTemplate(LevelTemplate *level);
+    // Filter, start snapshot and rewind history for a fresh level
+    void finishLevel();
+    // Delete the built world or hand the borrowed one back
+    void releaseWorld();
+
+    // Walls and ball for a level in a new world backed by `arena`; shared by
+    // buildLevel() and LevelCache
+    static b2World* createWorld(const LevelConfig& level, b2ArenaAllocator& arena, b2Body** ball,
+                                float* thinnestWall);
+
+    // Input mapping, force, Box2D step, moving water and hazards for one tick
+    void advance(int16_t inputX, int16_t inputY);
+    void stepAdaptive(const b2Vec2 &force);
+
+    // Ball back to the start (water hazard or reset())
+    void respawnBall();
+    void recordCheckpoint();
 };
 
 #endif
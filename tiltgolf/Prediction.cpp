@@ -0,0 +1,115 @@
+#include "Prediction.h"
+#include "PhysicsEngine.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+
+Prediction::Prediction() : Prediction(Options()) {}
+
+Prediction::Prediction(const Options &options) : opts(options), end(RESTING), failed(false), failedLevel(0) {
+    path.reserve(MAX_POINTS);
+    resetStats();
+}
+
+int Prediction::update(PhysicsEngine &physics) {
+    PROFILE_ZONE("Prediction::update");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    path.clear();
+    end = RESTING;
+    if (!physics.world || !physics.ballBody)
+        return 0;
+    if (failed && physics.currentLevel.id == failedLevel)
+        return 0;
+    failed = false;
+
+    int16_t x = physics.lastInputX;
+    int16_t y = physics.lastInputY;
+    if (physics.isAtRest() && !physics.tiltWakes(x, y)) {
+        path.push_back(physics.getBallPosition());
+        return pointCount();
+    }
+
+    int32 capacity = static_cast<int32>(state.size() * sizeof(uint64_t));
+    int32 size = physics.saveState(state.data(), capacity);
+    if (size == 0) {
+        // First update of a level, or more contacts than ever before; the
+        // snapshot grows with contacts, so leave room for twice as many bytes
+        state.resize((2 * static_cast<size_t>(physics.stateSize()) + 7) / 8);
+        capacity = static_cast<int32>(state.size() * sizeof(uint64_t));
+        size = physics.saveState(state.data(), capacity);
+        if (size == 0)
+            return 0;
+    }
+    uint32_t respawns = physics.respawnCount;
+    float hazardEntry = physics.hazardEntry;
+    b2Vec2 hazardEntryPoint = physics.hazardEntryPoint;
+    int substeps = physics.lastSubsteps;
+
+    int stride = std::max(1, physics.tickRate / std::max(1, opts.pointsPerSecond));
+    int ticks = std::min(static_cast<int>(opts.seconds * physics.tickRate), (MAX_POINTS - 2) * stride);
+
+    // advance() rather than stepWithInput(): no replay log, no rewind history
+    end = RUNNING;
+    path.push_back(physics.getBallPosition());
+    int tick = 1;
+    for (; tick <= ticks; ++tick) {
+        physics.advance(x, y);
+        if (physics.respawnCount != respawns) {
+            path.push_back(physics.hazardEntryPoint);
+            end = WATER;
+            break;
+        }
+        if (physics.isBallInHole()) {
+            path.push_back(physics.getBallPosition());
+            end = HOLE;
+            break;
+        }
+        if (tick % stride == 0) {
+            path.push_back(physics.getBallPosition());
+            if (std::chrono::steady_clock::now() - start > std::chrono::nanoseconds(opts.budgetNs)) {
+                end = tick < ticks ? BUDGET : RUNNING;
+                break;
+            }
+        }
+    }
+
+    bool restored = physics.restoreState(state.data(), size);
+    physics.respawnCount = respawns;
+    physics.hazardEntry = hazardEntry;
+    physics.hazardEntryPoint = hazardEntryPoint;
+    physics.lastSubsteps = substeps;
+    assert(restored && "Prediction: the live engine did not restore");
+    if (!restored) {
+        failed = true;
+        failedLevel = physics.currentLevel.id;
+        std::cerr << "Prediction: restoring the engine failed on level " << failedLevel
+                  << ", no more predictions for this level" << std::endl;
+        path.clear();
+        end = RESTING;
+        return 0;
+    }
+
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    counters.updates++;
+    counters.ticks += std::min(tick, ticks);
+    counters.cut += end == BUDGET;
+    counters.totalNs += ns;
+    counters.maxNs = std::max(counters.maxNs, ns);
+    return pointCount();
+}
+
+void Prediction::resetStats() {
+    counters = Stats();
+}
+
+void Prediction::report(std::ostream &out, const char *name) const {
+    const Stats &s = counters;
+    double meanUs = s.updates ? s.totalNs / 1000.0 / s.updates : 0.0;
+    double ticks = s.updates ? double(s.ticks) / s.updates : 0.0;
+    out << name << ": " << s.updates << " updates, mean " << meanUs << " us (max " << s.maxNs / 1000.0 << " us), "
+        << ticks << " ticks ahead each, " << s.cut << " cut short by the " << opts.budgetNs / 1000 << " us budget"
+        << std::endl;
+}
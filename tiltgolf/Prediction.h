@@ -0,0 +1,87 @@
+#ifndef PREDICTION_H
+#define PREDICTION_H
+
+#include <stdint.h>
+#include <ostream>
+#include <vector>
+
+#include "box2d/box2d.h"
+
+class PhysicsEngine;
+
+// Where the ball will roll if the player holds the current tilt, for the
+// dotted ghost path in the game view.
+//
+// Each update() forks the live engine in place: it snapshots it (saveState),
+// steps it ahead under the tilt of the last tick without recording or rewind
+// capture, and restores the snapshot, which puts the world back bit for bit.
+// (A second world cannot take the snapshot: it points into the world it came
+// from.) Because the lookahead is the full simulation (walls, contacts,
+// moving water, input filter), the path is exactly what the game will do if
+// the tilt does not change. It ends early in the hole or where the ball would
+// hit water. Respawn count, hazard entry and substeps are put back too; the
+// contact events are the lookahead's until the next tick.
+//
+// The lookahead stops when the horizon is reached or the time budget is
+// spent, whichever comes first, so a slow board gets a shorter ghost rather
+// than a late frame. Nothing allocates once the snapshot buffer has grown to
+// the level's size.
+//
+// If the snapshot ever fails to restore, the game would carry on from the
+// lookahead's future: debug builds assert, release builds log it and stop
+// predicting for the rest of that level.
+class Prediction {
+public:
+    static const int MAX_POINTS = 64;
+
+    struct Options {
+        float seconds = 1.5f;          // lookahead horizon
+        int pointsPerSecond = 20;      // path samples; MAX_POINTS caps the horizon
+        int64_t budgetNs = 2000000;    // per update(); 2 ms of a 16.7 ms frame
+    };
+
+    enum Ending {
+        RUNNING,   // still rolling at the horizon
+        RESTING,   // the live ball is at rest, nothing to predict
+        HOLE,      // reaches the hole
+        WATER,     // hits water; the last point is where it enters
+        BUDGET     // cut short by the time budget
+    };
+
+    struct Stats {
+        uint64_t updates;     // lookaheads run (resting frames are free)
+        uint64_t ticks;       // lookahead ticks simulated
+        uint64_t cut;         // updates stopped by the budget
+        int64_t totalNs;
+        int64_t maxNs;
+    };
+
+    Prediction();
+    explicit Prediction(const Options &options);
+
+    // Predict from the engine's current state and last tilt, then restore it;
+    // returns the number of points (0 without a level or once a restore has
+    // failed on this level)
+    int update(PhysicsEngine &physics);
+
+    // The ball's position now, then every 1/pointsPerSecond s
+    const b2Vec2 *points() const { return path.data(); }
+    int pointCount() const { return static_cast<int>(path.size()); }
+    Ending ending() const { return end; }
+
+    const Options &options() const { return opts; }
+    Stats stats() const { return counters; }
+    void resetStats();
+    void report(std::ostream &out, const char *name) const;
+
+private:
+    Options opts;
+    std::vector<uint64_t> state;     // snapshot of the fork point (8-byte aligned)
+    std::vector<b2Vec2> path;        // reserved to MAX_POINTS
+    Ending end;
+    Stats counters;
+    bool failed;         // a restore failed on failedLevel; no more lookaheads there
+    int failedLevel;
+};
+
+#endif
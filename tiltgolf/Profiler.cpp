@@ -0,0 +1,157 @@
+#include "Profiler.h"
+
+#ifdef TILTGOLF_PROFILE
+
+#include "box2d/b2_settings.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+
+// Zones per thread before the oldest ones are overwritten (~20 s of gameplay
+// at 60 Hz with the default zones).
+static const int RING_SIZE = 1 << 14;
+static const int MAX_THREADS = 16;
+static const int MAX_DEPTH = 32;
+
+struct ZoneEvent {
+    const char *name;
+    uint64_t beginNs;
+    uint64_t endNs;
+};
+
+struct ThreadRing {
+    ZoneEvent events[RING_SIZE];
+    uint32_t head;  // total zones ever closed; slot = head % RING_SIZE
+    int threadId;
+    // Open zones on this thread
+    const char *openNames[MAX_DEPTH];
+    uint64_t openBegins[MAX_DEPTH];
+    int depth;
+};
+
+static ThreadRing *rings[MAX_THREADS];
+static std::atomic<int> ringCount(0);
+static thread_local ThreadRing *localRing = nullptr;
+
+static const char *dumpPath = nullptr;
+static volatile std::sig_atomic_t dumpRequested = 0;
+
+static uint64_t nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// One allocation per thread, on its first zone
+static ThreadRing *threadRing()
+{
+    if (localRing)
+        return localRing;
+    int index = ringCount.fetch_add(1);
+    if (index >= MAX_THREADS)
+        return nullptr;
+    ThreadRing *ring = new ThreadRing();
+    ring->head = 0;
+    ring->threadId = index + 1;
+    ring->depth = 0;
+    rings[index] = ring;
+    localRing = ring;
+    return ring;
+}
+
+bool Profiler::enabled() { return true; }
+
+void Profiler::beginZone(const char *name)
+{
+    ThreadRing *ring = threadRing();
+    if (!ring)
+        return;
+    if (ring->depth < MAX_DEPTH) {
+        ring->openNames[ring->depth] = name;
+        ring->openBegins[ring->depth] = nowNs();
+    }
+    ring->depth++;
+}
+
+void Profiler::endZone()
+{
+    ThreadRing *ring = localRing;
+    if (!ring || ring->depth == 0)
+        return;
+    ring->depth--;
+    if (ring->depth >= MAX_DEPTH)
+        return;
+    ZoneEvent &e = ring->events[ring->head % RING_SIZE];
+    e.name = ring->openNames[ring->depth];
+    e.beginNs = ring->openBegins[ring->depth];
+    e.endNs = nowNs();
+    ring->head++;
+}
+
+bool Profiler::writeChromeTrace(const char *path)
+{
+    FILE *f = std::fopen(path, "w");
+    if (!f)
+        return false;
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    int threads = ringCount.load();
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    for (int t = 0; t < threads; ++t) {
+        const ThreadRing *ring = rings[t];
+        if (!ring)
+            continue;
+        uint32_t count = ring->head < static_cast<uint32_t>(RING_SIZE) ? ring->head : RING_SIZE;
+        for (uint32_t i = ring->head - count; i != ring->head; ++i) {
+            const ZoneEvent &e = ring->events[i % RING_SIZE];
+            std::fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         first ? "" : ",\n", e.name, ring->threadId,
+                         e.beginNs / 1000.0, (e.endNs - e.beginNs) / 1000.0);
+            first = false;
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+}
+
+static void onDumpSignal(int)
+{
+    dumpRequested = 1;
+}
+
+void Profiler::installDumpSignal(const char *path)
+{
+    dumpPath = path;
+    std::signal(SIGUSR1, onDumpSignal);
+}
+
+void Profiler::pollDump()
+{
+    if (!dumpRequested || !dumpPath)
+        return;
+    dumpRequested = 0;
+    if (writeChromeTrace(dumpPath))
+        std::fprintf(stderr, "Profiler: trace written to %s\n", dumpPath);
+    else
+        std::fprintf(stderr, "Profiler: failed to write %s\n", dumpPath);
+}
+
+// Box2D's b2_zone() markers (B2_PROFILE_ZONES) land in the same buffers
+void b2ZoneBegin(const char *name) { Profiler::beginZone(name); }
+void b2ZoneEnd() { Profiler::endZone(); }
+
+#else
+
+bool Profiler::enabled() { return false; }
+void Profiler::beginZone(const char *) {}
+void Profiler::endZone() {}
+bool Profiler::writeChromeTrace(const char *) { return false; }
+void Profiler::installDumpSignal(const char *) {}
+void Profiler::pollDump() {}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Scoped timing zones recorded into a per-thread ring buffer and exported as
+// Chrome/Perfetto trace JSON (open in chrome://tracing or ui.perfetto.dev).
+//
+// Only compiled in with CONFIG += trace_zones (defines TILTGOLF_PROFILE and
+// B2_PROFILE_ZONES so Box2D's b2_zone() markers feed the same buffers).
+// Otherwise PROFILE_ZONE expands to nothing and the Profiler calls are no-ops.
+//
+//   void GameController::gameLoop() {
+//       PROFILE_ZONE("GameController::gameLoop");
+//       ...
+//   }
+
+class Profiler {
+public:
+    static bool enabled();
+
+    // Open/close a zone on the calling thread. Names must be string literals
+    // (only the pointer is stored).
+    static void beginZone(const char *name);
+    static void endZone();
+
+    // Write every thread's buffered zones to a trace file. Returns false on I/O error.
+    static bool writeChromeTrace(const char *path);
+
+    // Dump on demand: after installDumpSignal(), `kill -USR1 <pid>` makes the
+    // next pollDump() call write the trace to path.
+    static void installDumpSignal(const char *path);
+    static void pollDump();
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char *name) { Profiler::beginZone(name); }
+    ~ProfileZone() { Profiler::endZone(); }
+
+private:
+    ProfileZone(const ProfileZone &);
+    ProfileZone &operator=(const ProfileZone &);
+};
+
+#ifdef TILTGOLF_PROFILE
+#define PROFILE_ZONE_CAT2(a, b) a##b
+#define PROFILE_ZONE_CAT(a, b) PROFILE_ZONE_CAT2(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CAT(profileZone_, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
+
+#endif
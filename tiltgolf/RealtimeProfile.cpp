@@ -0,0 +1,81 @@
+#include "RealtimeProfile.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Stack the game loop may reach
+static const size_t STACK_PREFAULT_BYTES = 256 * 1024;
+// Heap kept mapped for allocations made after startup
+static const size_t HEAP_RESERVE_BYTES = 4 * 1024 * 1024;
+
+static void prefaultStack() {
+    volatile unsigned char stack[STACK_PREFAULT_BYTES];
+    for (size_t i = 0; i < STACK_PREFAULT_BYTES; i += 4096)
+        stack[i] = 0;
+    (void)stack;
+}
+
+static void reportFailure(const char *step) {
+    std::cerr << "RealtimeProfile: " << step << " failed: " << std::strerror(errno) << std::endl;
+}
+
+bool RealtimeProfile::apply(int priority, int cpu) {
+    bool ok = true;
+
+    // 1. Keep the heap: no trimming, no per-allocation mmap
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    // 2. Touch everything the loop will use before locking
+    prefaultStack();
+    void *reserve = std::malloc(HEAP_RESERVE_BYTES);
+    if (reserve) {
+        std::memset(reserve, 0, HEAP_RESERVE_BYTES);
+        std::free(reserve);
+    }
+
+    // 3. No page faults from here on
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        reportFailure("mlockall");
+        ok = false;
+    }
+
+    // 4. Real-time priority for this thread
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err != 0) {
+        errno = err;
+        reportFailure("SCHED_FIFO");
+        ok = false;
+    }
+
+    // 5. Pin to one core, away from core 0 where most interrupts land
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu < 0 && cores > 1)
+        cpu = static_cast<int>(cores - 1);
+    if (cpu >= 0 && cpu < cores) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            errno = err;
+            reportFailure("CPU pinning");
+            ok = false;
+        }
+    }
+
+    std::cout << "RealtimeProfile: " << (ok ? "applied" : "partly applied") << " (SCHED_FIFO " << priority
+              << ", cpu " << (cpu >= 0 && cpu < cores ? cpu : -1) << " of " << cores << ")" << std::endl;
+    return ok;
+}
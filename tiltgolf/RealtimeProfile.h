@@ -0,0 +1,29 @@
+#ifndef REALTIMEPROFILE_H
+#define REALTIMEPROFILE_H
+
+// Opt-in real-time setup for the thread that runs the game loop (physics and
+// IMU reads happen there). Enabled with TILTGOLF_RT=1 in the game and --rt in
+// the headless runner; compare both with ./headless --clock-bench.
+//
+// apply() in order:
+//   1. stops glibc malloc from returning memory to the kernel, so freed
+//      blocks never have to be faulted in again
+//   2. prefaults the stack and a heap reserve (built-in levels are
+//      read-only data, locked with the rest of the image in step 3)
+//   3. mlockall(MCL_CURRENT | MCL_FUTURE)
+//   4. SCHED_FIFO at `priority` for the calling thread (threads it starts
+//      later inherit it)
+//   5. pins the thread to `cpu`; -1 picks the last core, and a single-core
+//      board (the BeagleBone) is left alone
+//
+// Steps that fail (usually missing CAP_SYS_NICE / CAP_IPC_LOCK or rlimits)
+// are reported and skipped; the game still runs.
+class RealtimeProfile {
+public:
+    static const int DEFAULT_PRIORITY = 50;
+
+    // Returns true if every step succeeded
+    static bool apply(int priority = DEFAULT_PRIORITY, int cpu = -1);
+};
+
+#endif
@@ -0,0 +1,263 @@
+#include "Replay.h"
+#include "IMU.h"
+#include "LevelData.h"
+#include "LevelPack.h"
+#include "PhysicsEngine.h"
+
+#include <cstring>
+#include <iostream>
+
+static const char REPLAY_MAGIC[4] = {'T', 'G', 'R', 'P'};
+static const uint8_t REPLAY_VERSION = 1;
+
+// ---------------------------------------------------------------- recorder
+
+InputRecorder::InputRecorder()
+    : file(nullptr), used(0), haveBias(false), lastBiasX(0), lastBiasY(0), ticks(0) {}
+
+InputRecorder::~InputRecorder() {
+    close();
+}
+
+bool InputRecorder::open(const char *path) {
+    close();
+    file = std::fopen(path, "wb");
+    if (!file) {
+        std::cerr << "InputRecorder: cannot open " << path << std::endl;
+        return false;
+    }
+    used = 0;
+    haveBias = false;
+    ticks = 0;
+    for (char c : REPLAY_MAGIC)
+        put(static_cast<uint8_t>(c));
+    put(REPLAY_VERSION);
+    return true;
+}
+
+void InputRecorder::close() {
+    if (!file)
+        return;
+    flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void InputRecorder::recordLevel(int levelId) {
+    if (!file) return;
+    put('L');
+    putI32(levelId);
+}
+
+void InputRecorder::recordTick(int16_t rawX, int16_t rawY, int32_t biasX, int32_t biasY) {
+    if (!file) return;
+    if (!haveBias || biasX != lastBiasX || biasY != lastBiasY) {
+        put('B');
+        putI32(biasX);
+        putI32(biasY);
+        lastBiasX = biasX;
+        lastBiasY = biasY;
+        haveBias = true;
+    }
+    put('T');
+    putI16(rawX);
+    putI16(rawY);
+    ticks++;
+}
+
+void InputRecorder::recordReset() {
+    if (!file) return;
+    put('R');
+}
+
+void InputRecorder::recordBallPosition(float x, float y, float angle) {
+    if (!file) return;
+    put('P');
+    putF32(x);
+    putF32(y);
+    putF32(angle);
+}
+
+void InputRecorder::recordCheckpoint(float x, float y, float angle) {
+    if (!file) return;
+    put('C');
+    putF32(x);
+    putF32(y);
+    putF32(angle);
+}
+
+void InputRecorder::recordRewind(int32_t ticks) {
+    if (!file) return;
+    put('W');
+    putI32(ticks);
+}
+
+void InputRecorder::recordStepping(bool adaptive) {
+    if (!file) return;
+    put('S');
+    put(adaptive ? 1 : 0);
+}
+
+void InputRecorder::recordTickRate(int32_t ticksPerSecond) {
+    if (!file) return;
+    put('H');
+    putI32(ticksPerSecond);
+}
+
+void InputRecorder::put(uint8_t byte) {
+    if (used == static_cast<int>(sizeof(buffer)))
+        flush();
+    buffer[used++] = byte;
+}
+
+void InputRecorder::putI16(int16_t v) {
+    uint16_t u = static_cast<uint16_t>(v);
+    put(static_cast<uint8_t>(u));
+    put(static_cast<uint8_t>(u >> 8));
+}
+
+void InputRecorder::putI32(int32_t v) {
+    uint32_t u = static_cast<uint32_t>(v);
+    for (int i = 0; i < 4; ++i)
+        put(static_cast<uint8_t>(u >> (8 * i)));
+}
+
+void InputRecorder::putF32(float v) {
+    int32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putI32(bits);
+}
+
+void InputRecorder::flush() {
+    if (file && used > 0)
+        std::fwrite(buffer, 1, used, file);
+    used = 0;
+}
+
+// ------------------------------------------------------------------ player
+
+ReplayPlayer::ReplayPlayer()
+    : pos(0), levels(nullptr), biasX(0), biasY(0), ticks(0), checkpoints(0), mismatches(0), firstMismatch(-1) {}
+
+bool ReplayPlayer::open(const char *path) {
+    data.clear();
+    FILE *f = std::fopen(path, "rb");
+    if (!f) {
+        std::cerr << "ReplayPlayer: cannot open " << path << std::endl;
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    if (data.size() < 5 || std::memcmp(data.data(), REPLAY_MAGIC, 4) != 0 || data[4] != REPLAY_VERSION) {
+        std::cerr << "ReplayPlayer: " << path << " is not a version " << int(REPLAY_VERSION) << " replay" << std::endl;
+        data.clear();
+        return false;
+    }
+    restart();
+    return true;
+}
+
+void ReplayPlayer::restart() {
+    pos = 5;
+    biasX = biasY = 0;
+    ticks = 0;
+    checkpoints = mismatches = 0;
+    firstMismatch = -1;
+}
+
+bool ReplayPlayer::read(void *dst, size_t size) {
+    if (pos + size > data.size())
+        return false;
+    std::memcpy(dst, data.data() + pos, size);
+    pos += size;
+    return true;
+}
+
+// Little-endian decoding helpers
+static int32_t decodeI32(const uint8_t *b) {
+    return static_cast<int32_t>(uint32_t(b[0]) | uint32_t(b[1]) << 8 | uint32_t(b[2]) << 16 | uint32_t(b[3]) << 24);
+}
+
+static int16_t decodeI16(const uint8_t *b) {
+    return static_cast<int16_t>(uint16_t(b[0]) | uint16_t(b[1]) << 8);
+}
+
+static float decodeF32(const uint8_t *b) {
+    int32_t bits = decodeI32(b);
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+bool ReplayPlayer::nextTick(PhysicsEngine &physics) {
+    uint8_t op;
+    uint8_t p[12];
+    while (read(&op, 1)) {
+        switch (op) {
+        case 'L':
+        {
+            if (!read(p, 4)) return false;
+            LevelView view;
+            if (levels && levels->find(decodeI32(p), view))
+                physics.loadLevel(view);
+            else
+                physics.loadLevel(LevelData::builtin(decodeI32(p)));
+            break;
+        }
+        case 'B':
+            if (!read(p, 8)) return false;
+            biasX = decodeI32(p);
+            biasY = decodeI32(p + 4);
+            break;
+        case 'T':
+            if (!read(p, 4)) return false;
+            physics.stepWithInput(IMU::applyBias(decodeI16(p), biasX), IMU::applyBias(decodeI16(p + 2), biasY));
+            ticks++;
+            return true;
+        case 'R':
+            physics.reset();
+            break;
+        case 'S':
+            if (!read(p, 1)) return false;
+            physics.setAdaptiveStepping(p[0] != 0);
+            break;
+        case 'H':
+            if (!read(p, 4)) return false;
+            physics.setTickRate(decodeI32(p));
+            break;
+        case 'W':
+            if (!read(p, 4)) return false;
+            if (!physics.rewind(decodeI32(p))) {
+                std::cerr << "ReplayPlayer: cannot rewind " << decodeI32(p) << " ticks at tick " << ticks << std::endl;
+                return false;
+            }
+            break;
+        case 'P':
+            if (!read(p, 12)) return false;
+            physics.setBallPosition(b2Vec2(decodeF32(p), decodeF32(p + 4)), decodeF32(p + 8));
+            break;
+        case 'C': {
+            if (!read(p, 12)) return false;
+            b2Vec2 ball = physics.getBallPosition();
+            float angle = physics.getBallAngle();
+            float expected[3] = {decodeF32(p), decodeF32(p + 4), decodeF32(p + 8)};
+            checkpoints++;
+            // Bitwise comparison: the whole point is bit-exact reproduction
+            if (std::memcmp(&expected[0], &ball.x, 4) || std::memcmp(&expected[1], &ball.y, 4) ||
+                std::memcmp(&expected[2], &angle, 4)) {
+                if (mismatches++ == 0)
+                    firstMismatch = static_cast<int64_t>(ticks);
+            }
+            break;
+        }
+        default:
+            std::cerr << "ReplayPlayer: bad record '" << op << "' at offset " << (pos - 1) << std::endl;
+            return false;
+        }
+    }
+    return false;
+}
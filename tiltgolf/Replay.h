@@ -0,0 +1,102 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+class LevelPack;
+class PhysicsEngine;
+
+// Deterministic input log for PhysicsEngine.
+//
+// A log is a 5-byte header ("TGRP" + version) followed by records, each a
+// one-byte opcode and a little-endian payload:
+//   'L' int32 levelId                     loadLevel() from the level pack, else LevelData
+//   'B' int32 biasX, int32 biasY          calibration bias (saved + temp) changed
+//   'T' int16 rawX, int16 rawY            one step() with these raw IMU samples
+//   'R'                                   reset()
+//   'P' f32 x, f32 y, f32 angle           setBallPosition()
+//   'C' f32 x, f32 y, f32 angle           checkpoint: expected ball state here
+//   'W' int32 ticks                       rewind() (needs a RewindBuffer attached)
+//   'S' u8 adaptive                       setAdaptiveStepping()
+//   'H' int32 ticksPerSecond              setTickRate()
+// Replaying the records through the same binary reproduces the run bit for bit;
+// checkpoints verify that.
+
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    void recordLevel(int levelId);
+    void recordTick(int16_t rawX, int16_t rawY, int32_t biasX, int32_t biasY);
+    void recordReset();
+    void recordBallPosition(float x, float y, float angle);
+    void recordCheckpoint(float x, float y, float angle);
+    void recordRewind(int32_t ticks);
+    void recordStepping(bool adaptive);
+    void recordTickRate(int32_t ticksPerSecond);
+
+    uint64_t tickCount() const { return ticks; }
+
+private:
+    InputRecorder(const InputRecorder &);
+    InputRecorder &operator=(const InputRecorder &);
+
+    void put(uint8_t byte);
+    void putI16(int16_t v);
+    void putI32(int32_t v);
+    void putF32(float v);
+    void flush();
+
+    FILE *file;
+    // Records are staged here and written in blocks so a tick never allocates
+    uint8_t buffer[4096];
+    int used;
+    bool haveBias;
+    int32_t lastBiasX, lastBiasY;
+    uint64_t ticks;
+};
+
+class ReplayPlayer {
+public:
+    ReplayPlayer();
+
+    // Load a whole log into memory. Returns false if it is missing or malformed.
+    bool open(const char *path);
+
+    // Apply records until one physics tick has run. Returns false at the end.
+    bool nextTick(PhysicsEngine &physics);
+
+    // Rewind to the first record
+    void restart();
+
+    // Levels the log was played with, if not the built-in ones. Ids missing
+    // from the pack still load from LevelData. Not owned.
+    void setLevelPack(const LevelPack *pack) { levels = pack; }
+
+    uint64_t tick() const { return ticks; }
+    int checkpointCount() const { return checkpoints; }
+    int mismatchCount() const { return mismatches; }
+    // Tick of the first checkpoint that did not match (-1 if none)
+    int64_t firstMismatchTick() const { return firstMismatch; }
+
+private:
+    bool read(void *dst, size_t size);
+
+    std::vector<uint8_t> data;
+    size_t pos;
+    const LevelPack *levels;
+    int32_t biasX, biasY;
+    uint64_t ticks;
+    int checkpoints;
+    int mismatches;
+    int64_t firstMismatch;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "Rewind.h"
+#include "PhysicsEngine.h"
+
+#include <algorithm>
+#include <iostream>
+
+RewindBuffer::RewindBuffer(size_t budgetBytes)
+    : budget(budgetBytes), slotBytes(0), keyCount(0), tickRate(60), head(0), oldest(0), warnedOverflow(false) {}
+
+void RewindBuffer::begin(const PhysicsEngine &physics) {
+    // Twice the current state leaves room for the contacts the ball picks up
+    // later in the level. Only grow, so restarting a level does not allocate.
+    size_t wanted = (2 * static_cast<size_t>(physics.stateSize()) + 7) & ~size_t(7);
+    if (wanted > slotBytes || frames.empty()) {
+        if (wanted > slotBytes)
+            slotBytes = wanted;
+
+        size_t perTick = sizeof(RewindFrame) + slotBytes / KEYFRAME_INTERVAL;
+        size_t ticks = budget / perTick;
+        if (ticks < static_cast<size_t>(2 * KEYFRAME_INTERVAL))
+            ticks = 2 * KEYFRAME_INTERVAL;
+
+        // One spare slot so the keyframe before the oldest frame is still there
+        keyCount = static_cast<int>(ticks / KEYFRAME_INTERVAL) + 2;
+        frames.resize(ticks);
+        keyStorage.resize(keyCount * slotBytes / sizeof(uint64_t));
+        keySize.resize(keyCount);
+        keyEntry.resize(keyCount);
+    }
+
+    tickRate = physics.getTickRate();
+    head = 0;
+    RewindFrame &f = frames[0];
+    f.position = physics.getBallPosition();
+    f.angle = physics.getBallAngle();
+    f.inputX = f.inputY = 0;
+    saveKeyframe(physics, 0);
+    head = 1;
+    oldest = 0;
+}
+
+void RewindBuffer::capture(const PhysicsEngine &physics) {
+    if (frames.empty())
+        return;
+    RewindFrame &f = frames[head % frames.size()];
+    f.position = physics.getBallPosition();
+    f.angle = physics.getBallAngle();
+    f.inputX = physics.getLastInputX();
+    f.inputY = physics.getLastInputY();
+    if (head % KEYFRAME_INTERVAL == 0)
+        saveKeyframe(physics, head);
+    head++;
+    // Once the ring wraps, the oldest frames may follow a keyframe whose
+    // earlier frames are gone, so keep one interval in reserve
+    if (head > frames.size())
+        oldest = std::max<uint64_t>(oldest, head - frames.size() + KEYFRAME_INTERVAL);
+}
+
+void RewindBuffer::saveKeyframe(const PhysicsEngine &physics, uint64_t entry) {
+    int slot = static_cast<int>((entry / KEYFRAME_INTERVAL) % keyCount);
+    void *memory = keyStorage.data() + slot * (slotBytes / sizeof(uint64_t));
+    keySize[slot] = physics.saveState(memory, static_cast<int32>(slotBytes));
+    keyEntry[slot] = entry;
+    if (keySize[slot] == 0 && !warnedOverflow) {
+        std::cerr << "RewindBuffer: state larger than " << slotBytes << " bytes, history has gaps" << std::endl;
+        warnedOverflow = true;
+    }
+}
+
+int RewindBuffer::available() const {
+    return head > oldest + 1 ? static_cast<int>(head - 1 - oldest) : 0;
+}
+
+float RewindBuffer::seconds() const {
+    return available() / static_cast<float>(tickRate);
+}
+
+const RewindFrame &RewindBuffer::frame(int ticksBack) const {
+    if (ticksBack > available())
+        ticksBack = available();
+    return frames[(head - 1 - ticksBack) % frames.size()];
+}
+
+bool RewindBuffer::rewind(PhysicsEngine &physics, int ticksBack) {
+    if (ticksBack <= 0 || ticksBack > available())
+        return false;
+
+    uint64_t target = head - 1 - ticksBack;
+    uint64_t key = target - target % KEYFRAME_INTERVAL;
+    int slot = static_cast<int>((key / KEYFRAME_INTERVAL) % keyCount);
+    const void *memory = keyStorage.data() + slot * (slotBytes / sizeof(uint64_t));
+    // Water hits in the replayed range were already counted when they were
+    // played; the replay must not count them (or report them) again
+    uint32_t respawns = physics.respawnCount;
+    float hazardEntry = physics.hazardEntry;
+    b2Vec2 hazardEntryPoint = physics.hazardEntryPoint;
+    if (keyEntry[slot] != key || keySize[slot] == 0 || !physics.restoreState(memory, keySize[slot]))
+        return false;
+
+    // Re-run the ticks between the keyframe and the target without logging or
+    // capturing them again; they are already in the history
+    for (uint64_t e = key + 1; e <= target; ++e) {
+        const RewindFrame &f = frames[e % frames.size()];
+        physics.advance(f.inputX, f.inputY);
+    }
+    physics.respawnCount = respawns;
+    physics.hazardEntry = hazardEntry;
+    physics.hazardEntryPoint = hazardEntryPoint;
+    head = target + 1;
+    return true;
+}
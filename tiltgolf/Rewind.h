@@ -0,0 +1,79 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "box2d/box2d.h"
+
+class PhysicsEngine;
+
+// Compact per-tick ball state, also enough to re-run the tick
+struct RewindFrame {
+    b2Vec2 position;
+    float angle;
+    int16_t inputX, inputY;  // calibrated tilt that produced this state
+};
+
+// History of the last few seconds of play, for rewinding after a water hazard.
+//
+// Every tick stores a 16-byte RewindFrame. Every KEYFRAME_INTERVAL ticks a full
+// PhysicsEngine snapshot (world, contacts, moving water) is stored as well.
+// Rewinding restores the nearest older snapshot and re-runs the recorded
+// inputs up to the requested tick, which reproduces it exactly because the
+// simulation is deterministic.
+//
+// All storage is sized by begin() from the memory budget; capture() and
+// rewind() never allocate.
+class RewindBuffer {
+public:
+    static const size_t DEFAULT_BUDGET_BYTES = 1024 * 1024;
+    static const int KEYFRAME_INTERVAL = 15;
+
+    explicit RewindBuffer(size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+
+    // Drop the history and start from the engine's current state.
+    // PhysicsEngine calls this on loadLevel(), reset() and setBallPosition().
+    void begin(const PhysicsEngine &physics);
+
+    // Append the state after one tick (PhysicsEngine calls this every step)
+    void capture(const PhysicsEngine &physics);
+
+    // Ticks that can currently be rewound
+    int available() const;
+    // Ticks the budget holds once full
+    int capacity() const { return static_cast<int>(frames.size()); }
+    float seconds() const;
+
+    // Ball state `ticksBack` ticks ago (0 = now), e.g. for a scrub preview
+    const RewindFrame &frame(int ticksBack) const;
+
+    // Restore the engine to `ticksBack` ticks ago and forget the newer ticks.
+    // Use PhysicsEngine::rewind() so the rewind is logged for replays.
+    bool rewind(PhysicsEngine &physics, int ticksBack);
+
+    size_t budgetBytes() const { return budget; }
+    size_t keyframeBytes() const { return slotBytes; }
+
+private:
+    void saveKeyframe(const PhysicsEngine &physics, uint64_t entry);
+
+    size_t budget;
+    std::vector<RewindFrame> frames;  // ring, entry % capacity
+    std::vector<uint64_t> keyStorage; // keyCount slots of slotBytes (8-byte aligned)
+    std::vector<int32> keySize;       // 0 if the state did not fit
+    std::vector<uint64_t> keyEntry;   // which entry a slot holds
+    size_t slotBytes;
+    int keyCount;
+    int tickRate;                     // from the engine at begin(), for seconds()
+
+    // Entries captured since begin(); entry 0 is the state begin() saw
+    uint64_t head;
+    // Oldest entry a rewind can reach. Only capture() moves it, forward, as
+    // the ring overwrites frames; a rewind never gets them back
+    uint64_t oldest;
+    bool warnedOverflow;
+};
+
+#endif
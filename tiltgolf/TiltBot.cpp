@@ -0,0 +1,333 @@
+#include "TiltBot.h"
+#include "GridSearch.h"
+#include "PhysicsEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Planning margins (metres)
+static const float WALL_CLEARANCE = 0.02f;   // on top of the ball radius
+static const float WATER_CLEARANCE = 0.15f;  // around the water's edge
+static const float SAFE_CLEARANCE = 0.75f;   // cells closer than this to a blocked one cost more
+static const float CENTRING = 3.0f;          // extra cost of a step that touches a blocked cell
+static const float SWEEP_COST = 3.0f;        // extra cost of a step where moving water passes
+
+// Controller tunables
+static const int LOOKAHEAD_CELLS = 16;       // aim point up to 2 m down the path, if in sight
+static const int SLOW_AHEAD_CELLS = 16;      // tight spots this far ahead slow the ball down
+static const float HOLE_APPROACH = 1.0f;     // metres; closer than this, aim straight at the hole
+static const float MAX_SPEED = 3.0f;         // m/s on open ground
+static const float MIN_SPEED = 0.5f;         // m/s through ball-width lanes
+static const float OPEN_CLEARANCE = 1.0f;    // clearance at which MAX_SPEED is allowed
+static const float BRAKING = 1.5f;           // m/s^2 planned deceleration into the hole
+static const float VELOCITY_GAIN = 4.0f;     // 1/s, velocity error to acceleration
+static const float MAX_FORCE = 3.0f;         // newtons, ~60 sensor counts
+static const float DAMPING = 0.8f;           // the ball's linearDamping, cancelled by the bot
+
+// Recovery
+static const float CAUTION_STEP = 0.7f;      // speed scale after each respawn
+static const float MIN_CAUTION = 0.3f;
+static const float PROGRESS = 0.25f;         // metres along the path that count as progress
+static const float STUCK_SECONDS = 3.0f;     // without progress before creeping
+static const float CREEP_SECONDS = 2.0f;
+static const int CREEP_CELLS = 2;            // aim point while creeping
+
+// Moving water
+static const float SWEEP_MARGIN = 0.4f;      // around the area a block sweeps
+static const float GATE_REACH = 2.0f;        // metres down the path to look for a sweep
+static const float HOLD_BACK = 0.5f;         // wait this far before the sweep
+static const float WATER_MARGIN = 0.3f;      // around the block while crossing
+static const float ACCELERATION = 3.0f;      // m/s^2 the ball can pick up (MAX_FORCE on ~0.8 kg, less damping)
+static const float TIME_SLACK = 0.25f;       // seconds either side of the predicted arrival
+static const int CROSSING_CELLS = 160;       // 20 m; no sweep is longer
+
+// Everywhere a moving block can be, grown by SWEEP_MARGIN
+static bool inSweep(const MovingWaterDef &m, const b2Vec2 &p) {
+    return std::fabs(p.x - m.basePosition.x) < m.size.x + SWEEP_MARGIN &&
+           std::fabs(p.y - m.basePosition.y) < m.size.y + std::fabs(m.amplitude) + SWEEP_MARGIN;
+}
+
+TiltBot::TiltBot(const LevelConfig &level) : hole(level.holePos), startDistance(-1.0f), noiseState(1), noiseCounts(0) {
+    cols = std::max(1, static_cast<int>(level.width / CELL));
+    rows = std::max(1, static_cast<int>(level.height / CELL));
+    distance.assign(cols * rows, -1.0f);
+    metres.assign(cols * rows, -1.0f);
+    parent.assign(cols * rows, -1);
+    restart();
+
+    // Free cells: the ball fits, and its centre stays out of the water
+    passable.assign(cols * rows, 0);
+    float wallReach = BALL_RADIUS + WALL_CLEARANCE;
+    for (int cell = 0; cell < cols * rows; ++cell) {
+        b2Vec2 p = cellCentre(cell);
+        bool ok = p.x >= wallReach && p.x <= level.width - wallReach && p.y >= wallReach &&
+                  p.y <= level.height - wallReach;
+        for (const WallDef &w : level.walls) {
+            if (!ok) break;
+            ok = GridSearch::boxDistance(p, w.position, w.size) >= wallReach;
+        }
+        for (const WallDef &w : level.water) {
+            if (!ok) break;
+            ok = GridSearch::boxDistance(p, w.position, w.size) >= WATER_CLEARANCE;
+        }
+        passable[cell] = ok;
+    }
+
+    // Clearance: two-pass chamfer distance to the nearest blocked cell
+    const float diagonal = CELL * std::sqrt(2.0f);
+    clearance.assign(cols * rows, 0.0f);
+    for (int cell = 0; cell < cols * rows; ++cell)
+        clearance[cell] = passable[cell] ? 1e9f : 0.0f;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            float &d = clearance[index(c, r)];
+            if (c > 0) d = std::min(d, clearance[index(c - 1, r)] + CELL);
+            if (r > 0) d = std::min(d, clearance[index(c, r - 1)] + CELL);
+            if (c > 0 && r > 0) d = std::min(d, clearance[index(c - 1, r - 1)] + diagonal);
+            if (c + 1 < cols && r > 0) d = std::min(d, clearance[index(c + 1, r - 1)] + diagonal);
+        }
+    }
+    for (int r = rows - 1; r >= 0; --r) {
+        for (int c = cols - 1; c >= 0; --c) {
+            float &d = clearance[index(c, r)];
+            if (c + 1 < cols) d = std::min(d, clearance[index(c + 1, r)] + CELL);
+            if (r + 1 < rows) d = std::min(d, clearance[index(c, r + 1)] + CELL);
+            if (c + 1 < cols && r + 1 < rows) d = std::min(d, clearance[index(c + 1, r + 1)] + diagonal);
+            if (c > 0 && r + 1 < rows) d = std::min(d, clearance[index(c - 1, r + 1)] + diagonal);
+        }
+    }
+
+    // Step weights: tight cells cost more, and so do the sweeps of moving
+    // water, so paths cross those straight rather than along them
+    std::vector<float> weight(cols * rows);
+    for (int cell = 0; cell < cols * rows; ++cell) {
+        weight[cell] = 1.0f + CENTRING * std::max(0.0f, SAFE_CLEARANCE - clearance[cell]) / SAFE_CLEARANCE;
+        for (const MovingWaterDef &m : level.movingWater) {
+            if (inSweep(m, cellCentre(cell))) {
+                weight[cell] += SWEEP_COST;
+                break;
+            }
+        }
+    }
+
+    // Cost, length and direction of the cheapest way to the hole from every cell
+    GridSearch::toHole(cols, rows, CELL, passable, hole, &weight, distance, &metres, &parent);
+
+    int start = nearestReachable(level.ballStartPos);
+    if (start >= 0)
+        startDistance = metres[start] + (cellCentre(start) - level.ballStartPos).Length();
+}
+
+b2Vec2 TiltBot::cellCentre(int cell) const {
+    return b2Vec2((cell % cols + 0.5f) * CELL, (cell / cols + 0.5f) * CELL);
+}
+
+int TiltBot::cellAt(const b2Vec2 &p) const {
+    int c = static_cast<int>(std::floor(p.x / CELL));
+    int r = static_cast<int>(std::floor(p.y / CELL));
+    if (c < 0 || c >= cols || r < 0 || r >= rows) return -1;
+    return index(c, r);
+}
+
+int TiltBot::nearestReachable(const b2Vec2 &p) const {
+    // A ball touching a wall sits right on the edge of the grown wall
+    int c0 = std::max(0, std::min(cols - 1, static_cast<int>(std::floor(p.x / CELL))));
+    int r0 = std::max(0, std::min(rows - 1, static_cast<int>(std::floor(p.y / CELL))));
+    int best = -1;
+    float bestDist = 0.0f;
+    for (int radius = 0; radius <= 6 && best < 0; ++radius) {
+        for (int r = r0 - radius; r <= r0 + radius; ++r) {
+            for (int c = c0 - radius; c <= c0 + radius; ++c) {
+                if (c < 0 || c >= cols || r < 0 || r >= rows) continue;
+                int cell = index(c, r);
+                if (distance[cell] < 0.0f) continue;
+                float d = (cellCentre(cell) - p).LengthSquared();
+                if (best < 0 || d < bestDist) {
+                    best = cell;
+                    bestDist = d;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+bool TiltBot::inSight(const b2Vec2 &from, const b2Vec2 &to) const {
+    b2Vec2 d = to - from;
+    int samples = static_cast<int>(d.Length() / (0.5f * CELL)) + 1;
+    for (int i = 1; i <= samples; ++i) {
+        int cell = cellAt(from + (float(i) / samples) * d);
+        if (cell < 0 || !passable[cell]) return false;
+    }
+    return true;
+}
+
+float TiltBot::sweepAhead(const PhysicsEngine &physics, int cell) const {
+    const std::vector<MovingWaterDef> &movers = physics.getLevelConfig().movingWater;
+    if (movers.empty()) return -1.0f;
+    b2Vec2 ball = physics.getBallPosition();
+    for (const MovingWaterDef &m : movers)
+        if (inSweep(m, ball)) return -1.0f;
+
+    for (int c = cell; metres[cell] - metres[c] <= GATE_REACH;) {
+        for (const MovingWaterDef &m : movers)
+            if (inSweep(m, cellCentre(c))) return metres[cell] - metres[c];
+        int next = nextCell(c);
+        if (next == c) break;
+        c = next;
+    }
+    return -1.0f;
+}
+
+bool TiltBot::crossingBlocked(const PhysicsEngine &physics, int cell, float speed) const {
+    // Arrival at each cell of the crossing if the ball sets off now, and the
+    // blocks then (the engine's motion, run forward from their current phase)
+    const std::vector<MovingWaterDef> &movers = physics.getLevelConfig().movingWater;
+    bool entered = false;
+    int c = cell;
+    for (int i = 0; i < CROSSING_CELLS; ++i) {
+        b2Vec2 p = cellCentre(c);
+        float arrival = (metres[cell] - metres[c]) / speed + speed / (2.0f * ACCELERATION);
+        bool inside = false;
+        for (const MovingWaterDef &m : movers) {
+            if (!inSweep(m, p)) continue;
+            inside = true;
+            float sign = m.direction >= 0.0f ? 1.0f : -1.0f;
+            for (int k = -1; k <= 1; ++k) {
+                float t = std::max(0.0f, arrival + k * TIME_SLACK);
+                float y = m.basePosition.y + m.amplitude * std::sin(m.phase + m.speed * t) * sign;
+                if (std::fabs(p.x - m.basePosition.x) < m.size.x + WATER_MARGIN &&
+                    std::fabs(p.y - y) < m.size.y + WATER_MARGIN)
+                    return true;
+            }
+        }
+        if (inside)
+            entered = true;
+        else if (entered)
+            break;
+        int next = nextCell(c);
+        if (next == c) break;
+        c = next;
+    }
+    return false;
+}
+
+void TiltBot::setNoise(uint32_t seed, int counts) {
+    noiseState = seed ? seed : 1;
+    noiseCounts = counts;
+}
+
+void TiltBot::restart() {
+    tick = 0;
+    respawnsSeen = 0;
+    caution = 1.0f;
+    bestMetres = -1.0f;
+    progressTick = 0;
+    recoverUntil = 0;
+    waited = recovered = 0;
+}
+
+float TiltBot::noise() {
+    // xorshift32, uniform in [-noiseCounts, noiseCounts]
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    return noiseCounts * ((noiseState >> 8) * (2.0f / 16777216.0f) - 1.0f);
+}
+
+void TiltBot::nextInput(const PhysicsEngine &physics, int16_t &inputX, int16_t &inputY) {
+    b2Vec2 pos = physics.getBallPosition();
+    b2Vec2 vel = physics.getBallVelocity();
+    float ticksPerSecond = static_cast<float>(physics.getTickRate());
+
+    // Back at the start after water: go slower from now on
+    uint32_t respawns = physics.getRespawnCount();
+    if (tick == 0)
+        respawnsSeen = respawns;
+    ++tick;
+    if (respawns != respawnsSeen) {
+        respawnsSeen = respawns;
+        caution = std::max(MIN_CAUTION, caution * CAUTION_STEP);
+        bestMetres = -1.0f;
+    }
+
+    // Aim straight at the hole once it is close, else down the path
+    b2Vec2 target = hole;
+    float remaining = (hole - pos).Length();
+    float cap = MAX_SPEED * caution;
+    int cell = nearestReachable(pos);
+    if (cell >= 0) {
+        if (bestMetres < 0.0f || metres[cell] < bestMetres - PROGRESS) {
+            bestMetres = metres[cell];
+            progressTick = tick;
+        }
+        if (tick - progressTick > STUCK_SECONDS * ticksPerSecond) {
+            recoverUntil = tick + static_cast<int>(CREEP_SECONDS * ticksPerSecond);
+            progressTick = tick;
+        }
+        bool creeping = tick < recoverUntil;
+        recovered += creeping;
+
+        if (metres[cell] > HOLE_APPROACH) {
+            // Farthest cell in sight within reach, and the tightest spot ahead
+            int reach = creeping ? CREEP_CELLS : LOOKAHEAD_CELLS;
+            b2Vec2 origin = cellCentre(cell);
+            int aim = nextCell(cell);
+            float tightest = clearance[cell];
+            bool sighted = true;
+            for (int i = 0, c = cell; i < SLOW_AHEAD_CELLS; ++i) {
+                int next = nextCell(c);
+                if (next == c) break;
+                c = next;
+                tightest = std::min(tightest, clearance[c]);
+                if (sighted && i < reach) {
+                    sighted = inSight(origin, cellCentre(c));
+                    if (sighted) aim = c;
+                }
+            }
+            target = cellCentre(aim);
+            remaining = metres[cell];
+            float open = std::min(1.0f, tightest / OPEN_CLEARANCE);
+            cap = creeping ? MIN_SPEED : std::max(MIN_SPEED, (MIN_SPEED + (MAX_SPEED - MIN_SPEED) * open) * caution);
+        }
+
+        // Stop short of moving water that the crossing would run into
+        float entry = sweepAhead(physics, cell);
+        if (entry >= 0.0f && crossingBlocked(physics, cell, cap)) {
+            remaining = std::min(remaining, std::max(0.0f, entry - HOLD_BACK));
+            waited++;
+            progressTick = tick;
+        }
+    }
+
+    // Desired velocity: towards the target, slow enough to stop in time
+    b2Vec2 toTarget = target - pos;
+    float length = toTarget.Length();
+    float speed = std::min(cap, std::sqrt(2.0f * BRAKING * remaining));
+    b2Vec2 desired = length > 1e-4f ? (speed / length) * toTarget : b2Vec2(0.0f, 0.0f);
+
+    // Hold the desired velocity against the ball's damping, correct the error
+    float mass = physics.getBallMass();
+    b2Vec2 force = mass * (DAMPING * desired + VELOCITY_GAIN * (desired - vel));
+    float magnitude = force.Length();
+    if (magnitude > MAX_FORCE)
+        force *= MAX_FORCE / magnitude;
+
+    physics.forceToInput(force, inputX, inputY);
+    if (noiseCounts > 0) {
+        inputX = static_cast<int16_t>(inputX + std::lround(noise()));
+        inputY = static_cast<int16_t>(inputY + std::lround(noise()));
+    }
+}
+
+int TiltBot::play(PhysicsEngine &physics, int maxTicks) {
+    restart();
+    int16_t x, y;
+    for (int tick = 0; tick < maxTicks; ++tick) {
+        nextInput(physics, x, y);
+        physics.stepWithInput(x, y);
+        if (physics.isBallInHole())
+            return tick + 1;
+    }
+    return -1;
+}
@@ -0,0 +1,100 @@
+#ifndef TILTBOT_H
+#define TILTBOT_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "box2d/box2d.h"
+#include "LevelData.h"
+
+class PhysicsEngine;
+
+// Automatic player: tilt input that rolls the ball from the start to the hole.
+//
+// The constructor plans once per level. Walls are grown by the ball radius and
+// still water by a small margin (water only catches the ball's centre). Each
+// free cell of a CELL-sized grid gets its clearance, the distance to the
+// nearest blocked cell, and a Dijkstra pass from the hole gives every free
+// cell its cost to the hole. Steps through tight cells cost more, so paths
+// keep to the middle of corridors instead of grazing the water.
+//
+// Each tick the bot aims at the farthest cell a short way down the path that
+// it can see in a straight line. It asks for a velocity towards that cell,
+// slower in tight places, before the hole and after falling in the water, and
+// turns the velocity error into a force. Before entering the sweep of moving
+// water it checks whether a crossing at that speed would meet the water, and
+// waits at the edge if so. With no progress for a while it creeps along the
+// path at low speed until it makes some. The force goes through
+// PhysicsEngine::forceToInput(), so the engine applies the same deadzone and
+// filter as to the real sensor.
+class TiltBot {
+public:
+    static constexpr float CELL = 0.125f;  // grid resolution (metres)
+
+    explicit TiltBot(const LevelConfig &level);
+
+    // Whether the planner found a way from the start to the hole
+    bool hasPath() const { return startDistance >= 0.0f; }
+    // Length of that way in metres (-1 without one)
+    float pathLength() const { return startDistance; }
+
+    // Random tilt error of up to `counts` per axis on every input, for
+    // rollouts that should not all play the same game
+    void setNoise(uint32_t seed, int counts);
+
+    // Forget the game so far (caution after respawns, progress); play() does
+    // this itself
+    void restart();
+
+    // Calibrated tilt for the next step
+    void nextInput(const PhysicsEngine &physics, int16_t &inputX, int16_t &inputY);
+
+    // Play the loaded level until the ball is in the hole. Returns the ticks
+    // taken, or -1 if it is not in after maxTicks.
+    int play(PhysicsEngine &physics, int maxTicks);
+
+    // Of the ticks since restart(): spent waiting for moving water, and
+    // spent creeping after getting stuck
+    int waitingTicks() const { return waited; }
+    int recoveringTicks() const { return recovered; }
+
+private:
+    int index(int col, int row) const { return row * cols + col; }
+    b2Vec2 cellCentre(int cell) const;
+    int cellAt(const b2Vec2 &p) const;
+    // Nearest cell with a path, searching outwards from p (-1 if none close)
+    int nearestReachable(const b2Vec2 &p) const;
+    // Next cell on the way to the hole (the cell itself at the hole)
+    int nextCell(int cell) const { return parent[cell]; }
+    // Whether the straight line between two points only crosses free cells
+    bool inSight(const b2Vec2 &from, const b2Vec2 &to) const;
+    // Path distance from `cell` to where it first enters the sweep of moving
+    // water, if that is close; -1 if not, or if the ball is already inside
+    float sweepAhead(const PhysicsEngine &physics, int cell) const;
+    // Whether a crossing from `cell` started now at `speed` meets moving water
+    bool crossingBlocked(const PhysicsEngine &physics, int cell, float speed) const;
+    float noise();
+
+    int cols, rows;
+    std::vector<char> passable;   // the ball's centre may go here
+    std::vector<float> clearance; // metres to the nearest blocked cell
+    std::vector<float> distance;  // path cost to the hole, < 0 if blocked or cut off
+    std::vector<float> metres;    // length of that path
+    std::vector<int> parent;      // next cell along it
+    b2Vec2 hole;
+    float startDistance;
+
+    uint32_t noiseState;
+    int noiseCounts;
+
+    // Per game
+    int tick;
+    uint32_t respawnsSeen;
+    float caution;                // speed scale, lowered by each respawn
+    float bestMetres;             // closest to the hole so far along the path
+    int progressTick;             // when bestMetres last improved
+    int recoverUntil;
+    int waited, recovered;
+};
+
+#endif
@@ -0,0 +1,423 @@
+#include "Trajectory.h"
+#include "PhysicsEngine.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char TRAJ_MAGIC[4] = {'T', 'G', 'T', 'J'};
+static const uint8_t TRAJ_VERSION = 1;
+static const size_t TRAJ_HEADER_BYTES = 16;
+static const size_t TRAJ_BLOCK_HEADER_BYTES = 8;
+static const size_t TRAJ_INDEX_ENTRY_BYTES = 16;
+static const size_t TRAJ_FOOTER_BYTES = 24;
+
+// Frame tag bits: which fields follow
+enum {
+    TRAJ_TAG_MOTION = 1 << 0, // x, y, angle deltas
+    TRAJ_TAG_INPUT  = 1 << 1, // inputX, inputY deltas
+    TRAJ_TAG_EVENTS = 1 << 2  // event bits (+ level delta if TRAJ_EVENT_LEVEL)
+};
+
+// Worst case per frame: tag + 3 position varints + 2 input varints + events + level
+static const size_t TRAJ_MAX_FRAME_BYTES = 1 + 3 * 5 + 2 * 3 + 5 + 5;
+
+// ------------------------------------------------------------ varint codec
+
+static inline uint32_t zigzag(int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1);
+}
+
+static inline uint8_t *putVarint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(v);
+    return p;
+}
+
+// Returns nullptr on a truncated or overlong varint
+static inline const uint8_t *getVarint(const uint8_t *p, const uint8_t *end, uint32_t &v) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        result |= static_cast<uint32_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            v = result;
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+static void putLE(uint8_t *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i)
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+static uint64_t getLE(const uint8_t *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i)
+        v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+static int32_t quantize(float v) {
+    float q = v * static_cast<float>(TrajectoryWriter::QUANTA_PER_UNIT);
+    // Clamp so a runaway angle cannot overflow the int32 predictor
+    if (q > 1.0e9f) q = 1.0e9f;
+    if (q < -1.0e9f) q = -1.0e9f;
+    return static_cast<int32_t>(std::lround(q));
+}
+
+// ------------------------------------------------------------------ writer
+
+TrajectoryWriter::TrajectoryWriter()
+    : file(nullptr), blockFrames(DEFAULT_BLOCK_FRAMES), blockUsed(0), framesInBlock(0),
+      frames(0), written(0), dropped(0), ok(false), prevX(0), prevY(0), prevAngle(0),
+      prevInputX(0), prevInputY(0), prevLevel(0), lastLevelId(-1), lastRespawns(0) {}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    close();
+}
+
+bool TrajectoryWriter::open(const char *path, uint32_t framesPerBlock) {
+    close();
+    file = std::fopen(path, "wb");
+    if (!file) {
+        std::cerr << "TrajectoryWriter: cannot open " << path << std::endl;
+        return false;
+    }
+    blockFrames = framesPerBlock > 0 ? framesPerBlock : DEFAULT_BLOCK_FRAMES;
+    // Allocate the block and the index up front so addFrame() never touches
+    // the heap
+    block.assign(5 + blockFrames * TRAJ_MAX_FRAME_BYTES, 0);
+    blockUsed = 0;
+    framesInBlock = 0;
+    index.clear();
+    index.reserve(2 * MAX_BLOCKS);
+    frames = 0;
+    written = 0;
+    dropped = 0;
+    ok = true;
+    lastLevelId = -1;
+    lastRespawns = 0;
+
+    uint8_t header[TRAJ_HEADER_BYTES] = {0};
+    std::memcpy(header, TRAJ_MAGIC, 4);
+    header[4] = TRAJ_VERSION;
+    putLE(header + 8, blockFrames, 4);
+    putLE(header + 12, QUANTA_PER_UNIT, 4);
+    return writeBytes(header, sizeof(header));
+}
+
+bool TrajectoryWriter::close() {
+    if (!file)
+        return false;
+    flushBlock();
+
+    uint64_t indexOffset = written;
+    uint8_t entry[TRAJ_INDEX_ENTRY_BYTES];
+    for (size_t i = 0; i + 1 < index.size(); i += 2) {
+        putLE(entry, index[i], 8);
+        putLE(entry + 8, index[i + 1], 8);
+        writeBytes(entry, sizeof(entry));
+    }
+
+    uint8_t footer[TRAJ_FOOTER_BYTES];
+    putLE(footer, indexOffset, 8);
+    putLE(footer + 8, frames, 8);
+    putLE(footer + 16, index.size() / 2, 4);
+    std::memcpy(footer + 20, TRAJ_MAGIC, 4);
+    writeBytes(footer, sizeof(footer));
+
+    bool success = ok && std::fclose(file) == 0;
+    file = nullptr;
+    if (!success)
+        std::cerr << "TrajectoryWriter: write failed" << std::endl;
+    if (dropped)
+        std::cerr << "TrajectoryWriter: index full after " << MAX_BLOCKS << " blocks, dropped the last "
+                  << dropped << " frames" << std::endl;
+    return success;
+}
+
+void TrajectoryWriter::addFrame(const PhysicsEngine &physics, uint32_t events) {
+    if (!file) return;
+
+    const LevelConfig &level = physics.getLevelConfig();
+    if (level.id != lastLevelId) {
+        events |= TRAJ_EVENT_LEVEL;
+        lastLevelId = level.id;
+        lastRespawns = physics.getRespawnCount();
+    }
+    if (physics.getRespawnCount() != lastRespawns) {
+        events |= TRAJ_EVENT_RESPAWN;
+        lastRespawns = physics.getRespawnCount();
+    }
+    if (physics.getContactEvents().GetBeginEventCount() > 0)
+        events |= TRAJ_EVENT_CONTACT;
+
+    TrajectoryFrame frame;
+    b2Vec2 pos = physics.getBallPosition();
+    frame.x = pos.x;
+    frame.y = pos.y;
+    frame.angle = physics.getBallAngle();
+    frame.inputX = physics.getLastInputX();
+    frame.inputY = physics.getLastInputY();
+    frame.events = events;
+    frame.levelId = level.id;
+    addFrame(frame);
+}
+
+void TrajectoryWriter::addFrame(const TrajectoryFrame &frame) {
+    if (!file) return;
+
+    uint8_t *p = block.data() + blockUsed;
+    if (framesInBlock == 0) {
+        if (index.size() >= 2 * MAX_BLOCKS) {
+            dropped++;
+            return;
+        }
+        // Block starts from zero predictors; only the level has to be spelled out
+        index.push_back(written);
+        index.push_back(frames);
+        prevX = prevY = prevAngle = 0;
+        prevInputX = prevInputY = 0;
+        prevLevel = frame.levelId;
+        p = putVarint(p, zigzag(frame.levelId));
+    }
+
+    int32_t qx = quantize(frame.x);
+    int32_t qy = quantize(frame.y);
+    int32_t qa = quantize(frame.angle);
+    uint32_t events = frame.events;
+    if (frame.levelId != prevLevel)
+        events |= TRAJ_EVENT_LEVEL;
+
+    uint32_t tag = 0;
+    if (qx != prevX || qy != prevY || qa != prevAngle) tag |= TRAJ_TAG_MOTION;
+    if (frame.inputX != prevInputX || frame.inputY != prevInputY) tag |= TRAJ_TAG_INPUT;
+    if (events) tag |= TRAJ_TAG_EVENTS;
+
+    p = putVarint(p, tag);
+    if (tag & TRAJ_TAG_MOTION) {
+        p = putVarint(p, zigzag(qx - prevX));
+        p = putVarint(p, zigzag(qy - prevY));
+        p = putVarint(p, zigzag(qa - prevAngle));
+        prevX = qx;
+        prevY = qy;
+        prevAngle = qa;
+    }
+    if (tag & TRAJ_TAG_INPUT) {
+        p = putVarint(p, zigzag(frame.inputX - prevInputX));
+        p = putVarint(p, zigzag(frame.inputY - prevInputY));
+        prevInputX = frame.inputX;
+        prevInputY = frame.inputY;
+    }
+    if (tag & TRAJ_TAG_EVENTS) {
+        p = putVarint(p, events);
+        if (events & TRAJ_EVENT_LEVEL) {
+            p = putVarint(p, zigzag(frame.levelId - prevLevel));
+            prevLevel = frame.levelId;
+        }
+    }
+
+    blockUsed = p - block.data();
+    frames++;
+    if (++framesInBlock == blockFrames)
+        flushBlock();
+}
+
+void TrajectoryWriter::flushBlock() {
+    if (framesInBlock == 0)
+        return;
+    uint8_t header[TRAJ_BLOCK_HEADER_BYTES];
+    putLE(header, framesInBlock, 4);
+    putLE(header + 4, blockUsed, 4);
+    writeBytes(header, sizeof(header));
+    writeBytes(block.data(), blockUsed);
+    blockUsed = 0;
+    framesInBlock = 0;
+}
+
+bool TrajectoryWriter::writeBytes(const void *data, size_t size) {
+    if (std::fwrite(data, 1, size, file) != size)
+        ok = false;
+    written += size;
+    return ok;
+}
+
+// ------------------------------------------------------------------ reader
+
+TrajectoryReader::TrajectoryReader()
+    : map(nullptr), size(0), blockFrames(0), scale(0.0f), frames(0), blocks(0), indexData(nullptr),
+      currentBlock(0), cursor(nullptr), blockEnd(nullptr), leftInBlock(0), frameNumber(0),
+      prevX(0), prevY(0), prevAngle(0), prevInputX(0), prevInputY(0), prevLevel(0) {}
+
+TrajectoryReader::~TrajectoryReader() {
+    close();
+}
+
+bool TrajectoryReader::open(const char *path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "TrajectoryReader: cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(TRAJ_HEADER_BYTES + TRAJ_FOOTER_BYTES)) {
+        std::cerr << "TrajectoryReader: " << path << " is too short" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    void *m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive
+    ::close(fd);
+    if (m == MAP_FAILED) {
+        std::cerr << "TrajectoryReader: mmap failed for " << path << std::endl;
+        size = 0;
+        return false;
+    }
+    map = static_cast<const uint8_t *>(m);
+    madvise(m, size, MADV_SEQUENTIAL);
+
+    const uint8_t *footer = map + size - TRAJ_FOOTER_BYTES;
+    uint64_t indexOffset = getLE(footer, 8);
+    frames = getLE(footer + 8, 8);
+    blocks = static_cast<uint32_t>(getLE(footer + 16, 4));
+    blockFrames = static_cast<uint32_t>(getLE(map + 8, 4));
+    uint32_t quanta = static_cast<uint32_t>(getLE(map + 12, 4));
+
+    bool valid = std::memcmp(map, TRAJ_MAGIC, 4) == 0 && map[4] == TRAJ_VERSION &&
+                 std::memcmp(footer + 20, TRAJ_MAGIC, 4) == 0 && blockFrames > 0 && quanta > 0 &&
+                 indexOffset >= TRAJ_HEADER_BYTES &&
+                 indexOffset + uint64_t(blocks) * TRAJ_INDEX_ENTRY_BYTES == size - TRAJ_FOOTER_BYTES;
+    if (!valid) {
+        std::cerr << "TrajectoryReader: " << path << " is not a complete version "
+                  << int(TRAJ_VERSION) << " trajectory" << std::endl;
+        close();
+        return false;
+    }
+    scale = 1.0f / static_cast<float>(quanta);
+    indexData = map + indexOffset;
+    return seek(0);
+}
+
+void TrajectoryReader::close() {
+    if (map)
+        munmap(const_cast<uint8_t *>(map), size);
+    map = nullptr;
+    size = 0;
+    frames = 0;
+    blocks = 0;
+    indexData = nullptr;
+    cursor = blockEnd = nullptr;
+    leftInBlock = 0;
+}
+
+bool TrajectoryReader::enterBlock(uint32_t b) {
+    if (b >= blocks)
+        return false;
+    uint64_t offset = getLE(indexData + b * TRAJ_INDEX_ENTRY_BYTES, 8);
+    uint64_t first = getLE(indexData + b * TRAJ_INDEX_ENTRY_BYTES + 8, 8);
+    if (offset + TRAJ_BLOCK_HEADER_BYTES > size)
+        return false;
+    const uint8_t *header = map + offset;
+    uint32_t count = static_cast<uint32_t>(getLE(header, 4));
+    uint64_t bytes = getLE(header + 4, 4);
+    if (offset + TRAJ_BLOCK_HEADER_BYTES + bytes > size)
+        return false;
+
+    cursor = header + TRAJ_BLOCK_HEADER_BYTES;
+    blockEnd = cursor + bytes;
+    uint32_t level;
+    if (!(cursor = getVarint(cursor, blockEnd, level)))
+        return false;
+    currentBlock = b;
+    leftInBlock = count;
+    frameNumber = first;
+    prevX = prevY = prevAngle = 0;
+    prevInputX = prevInputY = 0;
+    prevLevel = unzigzag(level);
+    return true;
+}
+
+bool TrajectoryReader::seek(uint64_t n) {
+    if (!map || n > frames)
+        return false;
+    if (n == frames) {
+        // End of stream: next() returns false
+        cursor = blockEnd = nullptr;
+        leftInBlock = 0;
+        currentBlock = blocks;
+        frameNumber = n;
+        return true;
+    }
+    // Every block but the last is full, so the block is a division away
+    if (!enterBlock(static_cast<uint32_t>(n / blockFrames)))
+        return false;
+    TrajectoryFrame skip;
+    while (frameNumber < n)
+        if (!next(skip))
+            return false;
+    return true;
+}
+
+bool TrajectoryReader::next(TrajectoryFrame &frame) {
+    if (leftInBlock == 0 && !enterBlock(currentBlock + 1))
+        return false;
+
+    uint32_t tag, v;
+    if (!(cursor = getVarint(cursor, blockEnd, tag)))
+        goto corrupt;
+    if (tag & TRAJ_TAG_MOTION) {
+        if (!(cursor = getVarint(cursor, blockEnd, v))) goto corrupt;
+        prevX += unzigzag(v);
+        if (!(cursor = getVarint(cursor, blockEnd, v))) goto corrupt;
+        prevY += unzigzag(v);
+        if (!(cursor = getVarint(cursor, blockEnd, v))) goto corrupt;
+        prevAngle += unzigzag(v);
+    }
+    if (tag & TRAJ_TAG_INPUT) {
+        if (!(cursor = getVarint(cursor, blockEnd, v))) goto corrupt;
+        prevInputX += unzigzag(v);
+        if (!(cursor = getVarint(cursor, blockEnd, v))) goto corrupt;
+        prevInputY += unzigzag(v);
+    }
+    frame.events = 0;
+    if (tag & TRAJ_TAG_EVENTS) {
+        if (!(cursor = getVarint(cursor, blockEnd, frame.events))) goto corrupt;
+        if (frame.events & TRAJ_EVENT_LEVEL) {
+            if (!(cursor = getVarint(cursor, blockEnd, v))) goto corrupt;
+            prevLevel += unzigzag(v);
+        }
+    }
+
+    frame.x = prevX * scale;
+    frame.y = prevY * scale;
+    frame.angle = prevAngle * scale;
+    frame.inputX = static_cast<int16_t>(prevInputX);
+    frame.inputY = static_cast<int16_t>(prevInputY);
+    frame.levelId = prevLevel;
+    leftInBlock--;
+    frameNumber++;
+    return true;
+
+corrupt:
+    std::cerr << "TrajectoryReader: corrupt frame " << frameNumber << std::endl;
+    leftInBlock = 0;
+    currentBlock = blocks;
+    return false;
+}
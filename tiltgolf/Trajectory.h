@@ -0,0 +1,142 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+class PhysicsEngine;
+
+// Compact ball trajectory stream for ghost balls, analytics and benchmarks.
+//
+// Unlike a replay log (Replay.h) this stores the simulated result, not just
+// the input, so it can be drawn or analysed without running Box2D.
+//
+// Layout (all integers little-endian):
+//   header  "TGTJ", u8 version, 3 pad bytes, u32 framesPerBlock, u32 quantaPerUnit
+//   blocks  u32 frameCount, u32 payloadBytes, payload
+//   index   per block: u64 fileOffset, u64 firstFrame
+//   footer  u64 indexOffset, u64 frameCount, u32 blockCount, "TGTJ"
+//
+// Positions and angle are quantized to 1/quantaPerUnit (m, rad). Each frame is
+// a tag varint (TRAJ_TAG_*) followed by zigzag varint deltas of the enabled
+// fields. Deltas restart from zero at every block, so any block decodes on its
+// own and seek() only has to decode from the start of one block.
+
+enum TrajectoryEvent {
+    TRAJ_EVENT_LEVEL   = 1 << 0, // first frame of a level (levelId is valid)
+    TRAJ_EVENT_RESPAWN = 1 << 1, // ball put back at the start (water or reset)
+    TRAJ_EVENT_CONTACT = 1 << 2, // ball started touching something
+    TRAJ_EVENT_HOLE    = 1 << 3  // ball reached the hole
+};
+
+struct TrajectoryFrame {
+    float x, y, angle;
+    int16_t inputX, inputY;  // calibrated tilt used for this step
+    uint32_t events;         // TrajectoryEvent bits
+    int32_t levelId;         // level the frame belongs to
+};
+
+class TrajectoryWriter {
+public:
+    // 4096 quanta per metre/radian: 0.25 mm, well below a pixel on the LCD
+    static const uint32_t QUANTA_PER_UNIT = 4096;
+    static const uint32_t DEFAULT_BLOCK_FRAMES = 256;
+    // Longest session: the block index is allocated at open() for this many
+    // blocks (64 KB), 1M frames or 4.8 h at 60 Hz with the default block
+    // size. Frames past it are dropped and counted rather than grow the
+    // index on the game thread.
+    static const uint32_t MAX_BLOCKS = 4096;
+
+    TrajectoryWriter();
+    ~TrajectoryWriter();
+
+    bool open(const char *path, uint32_t framesPerBlock = DEFAULT_BLOCK_FRAMES);
+    // Writes the last block, the index and the footer
+    bool close();
+    bool isOpen() const { return file != nullptr; }
+
+    // Append the ball state after a PhysicsEngine step. Level changes,
+    // respawns and new contacts are detected from the engine; extra events
+    // (e.g. TRAJ_EVENT_HOLE from the game logic) can be passed in.
+    void addFrame(const PhysicsEngine &physics, uint32_t events = 0);
+    void addFrame(const TrajectoryFrame &frame);
+
+    uint64_t frameCount() const { return frames; }
+    uint64_t bytesWritten() const { return written; }
+    uint64_t droppedFrames() const { return dropped; }
+
+private:
+    TrajectoryWriter(const TrajectoryWriter &);
+    TrajectoryWriter &operator=(const TrajectoryWriter &);
+
+    void flushBlock();
+    bool writeBytes(const void *data, size_t size);
+
+    FILE *file;
+    uint32_t blockFrames;
+    std::vector<uint8_t> block;   // sized at open(), holds one encoded block
+    size_t blockUsed;
+    uint32_t framesInBlock;
+    std::vector<uint64_t> index;  // offset, firstFrame pairs
+    uint64_t frames;
+    uint64_t written;
+    uint64_t dropped;             // past MAX_BLOCKS
+    bool ok;
+
+    // Delta predictors, reset at each block
+    int32_t prevX, prevY, prevAngle;
+    int32_t prevInputX, prevInputY, prevLevel;
+
+    // Engine state seen on the previous addFrame(physics)
+    int lastLevelId;
+    uint32_t lastRespawns;
+};
+
+class TrajectoryReader {
+public:
+    // Size of one frame stored uncompressed (3 floats, 2 int16, u32 events),
+    // the baseline for compression ratios
+    static const size_t RAW_FRAME_BYTES = 20;
+
+    TrajectoryReader();
+    ~TrajectoryReader();
+
+    // Map the file read-only. Frames are decoded straight from the mapping.
+    bool open(const char *path);
+    void close();
+
+    uint64_t frameCount() const { return frames; }
+    uint32_t blockCount() const { return blocks; }
+    size_t fileBytes() const { return size; }
+
+    // Position so the next call to next() returns frame n
+    bool seek(uint64_t n);
+    bool next(TrajectoryFrame &frame);
+
+private:
+    TrajectoryReader(const TrajectoryReader &);
+    TrajectoryReader &operator=(const TrajectoryReader &);
+
+    bool enterBlock(uint32_t b);
+
+    const uint8_t *map;
+    size_t size;
+    uint32_t blockFrames;
+    float scale;          // 1 / quantaPerUnit
+    uint64_t frames;
+    uint32_t blocks;
+    const uint8_t *indexData;
+
+    uint32_t currentBlock;
+    const uint8_t *cursor;
+    const uint8_t *blockEnd;
+    uint32_t leftInBlock;
+    uint64_t frameNumber;
+
+    int32_t prevX, prevY, prevAngle;
+    int32_t prevInputX, prevInputY, prevLevel;
+};
+
+#endif
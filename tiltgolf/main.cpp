@@ -1,5 +1,7 @@
 #include "MainWindow.h"
+#include "RealtimeProfile.h"
 #include <QApplication>
+#include <cstdlib>
 
 int main(int argc, char *argv[])
 {
@@ -8,5 +10,9 @@ int main(int argc, char *argv[])
     MainWindow main;
     main.showFullScreen();
 
+    // Opt-in: lock memory and run the game loop thread at real-time priority
+    if (std::getenv("TILTGOLF_RT"))
+        RealtimeProfile::apply();
+
     return app.exec();
 }
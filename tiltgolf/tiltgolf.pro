@@ -15,9 +15,22 @@ LIBS += -lm
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Allocation-tracking build: qmake "CONFIG += track_allocs"
+# Counts operator new and b2Alloc (see AllocTracker.h, b2_user_settings.h)
+track_allocs {
+    DEFINES += TILTGOLF_TRACK_ALLOCS B2_USER_SETTINGS
+    QMAKE_LFLAGS += -rdynamic
+}
+
+# Profiling build: qmake "CONFIG += trace_zones"
+# Scoped zones in the game and Box2D, dumped as Chrome trace JSON (see Profiler.h)
+trace_zones {
+    DEFINES += TILTGOLF_PROFILE B2_PROFILE_ZONES
+}
+
 # Input
-HEADERS += MainWindow.h MenuScreen.h GameScreen.h IMU.h GameView.h GameController.h PhysicsEngine.h LevelData.h CalibrationDialog.h
+HEADERS += MainWindow.h MenuScreen.h GameScreen.h IMU.h GameView.h GameController.h PhysicsEngine.h LevelCache.h BackgroundWorker.h LevelData.h CalibrationDialog.h AllocTracker.h b2_user_settings.h Profiler.h Replay.h Trajectory.h Rewind.h FrameClock.h RealtimeProfile.h LevelPack.h FlowField.h GridSearch.h Prediction.h
 
-SOURCES += main.cpp MainWindow.cpp MenuScreen.cpp GameScreen.cpp IMU.cpp GameView.cpp GameController.cpp PhysicsEngine.cpp CalibrationDialog.cpp
+SOURCES += main.cpp MainWindow.cpp MenuScreen.cpp GameScreen.cpp IMU.cpp GameView.cpp GameController.cpp PhysicsEngine.cpp LevelCache.cpp BackgroundWorker.cpp LevelData.cpp CalibrationDialog.cpp AllocTracker.cpp Profiler.cpp Replay.cpp Trajectory.cpp Rewind.cpp FrameClock.cpp RealtimeProfile.cpp LevelPack.cpp FlowField.cpp GridSearch.cpp Prediction.cpp
 
 QT += core gui widgets
@@ -0,0 +1,1242 @@
+// Headless runner: drives PhysicsEngine without Qt or an IMU so levels can be
+// exercised on a desktop or over ssh on the board.
+
+#include "PhysicsEngine.h"
+#include "LevelCache.h"
+#include "LevelData.h"
+#include "LevelGenerator.h"
+#include "LevelPack.h"
+#include "Prediction.h"
+#include "AllocTracker.h"
+#include "BatchEnv.h"
+#include "Difficulty.h"
+#include "FlowField.h"
+#include "FrameClock.h"
+#include "Profiler.h"
+#include "RealtimeProfile.h"
+#include "Replay.h"
+#include "Rewind.h"
+#include "TiltBot.h"
+#include "Trajectory.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static const int NUM_LEVELS = LevelData::LEVEL_COUNT;
+
+// Physics ticks per second (--tick-rate); the script follows wall-clock time
+static int tickRate = 60;
+
+// --levels PACK: levels come from the pack, ids it lacks are skipped
+static LevelPack levelPack;
+
+static bool findLevel(int id, LevelView &level)
+{
+    if (!levelPack.isOpen()) {
+        level = LevelData::builtin(id);
+        return true;
+    }
+    return levelPack.find(id, level);
+}
+
+static bool loadLevel(PhysicsEngine &physics, int id)
+{
+    LevelView level;
+    if (!findLevel(id, level))
+        return false;
+    physics.loadLevel(level);
+    return true;
+}
+
+// Queue the requested levels for a background build
+static void prepareCache(LevelCache &cache, int firstLevel, int lastLevel)
+{
+    std::vector<LevelView> levels;
+    LevelView level;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        if (findLevel(id, level))
+            levels.push_back(level);
+    }
+    cache.prepare(levels);
+}
+
+// Slow circular tilt sweep so the ball rolls into walls, water and the hole area.
+// Values are calibrated sensor counts, the same units IMU::getX/getY return.
+static void scriptedInput(int tick, int16_t &x, int16_t &y)
+{
+    const float amplitude = 30.0f;
+    float t = tick * (1.0f / tickRate);
+    x = static_cast<int16_t>(amplitude * b2Cos(0.7f * t));
+    y = static_cast<int16_t>(amplitude * b2Sin(0.5f * t));
+}
+
+// Steps every requested level; after warm-up no tick may touch the heap.
+static bool checkAllocs(PhysicsEngine &physics, int firstLevel, int lastLevel, int warmupTicks, int ticks)
+{
+    if (!AllocTracker::enabled()) {
+        std::fprintf(stderr, "headless: --check-allocs needs the track_allocs build\n");
+        return false;
+    }
+
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        if (!loadLevel(physics, id))
+            continue;
+
+        int tick = 0;
+        int16_t x, y;
+        for (; tick < warmupTicks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+        }
+
+        AllocTracker::begin();
+        for (; tick < warmupTicks + ticks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+        }
+        AllocTracker::end();
+
+        if (AllocTracker::count() == 0) {
+            std::printf("level %d: 0 allocations in %d ticks\n", id, ticks);
+        } else {
+            std::printf("level %d: FAILED, %llu allocations in %d ticks\n", id,
+                        (unsigned long long)AllocTracker::count(), ticks);
+            AllocTracker::report();
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Save mid-level, run on, restore and run the same ticks again: both runs must
+// end bit for bit in the same place. Also times save and restore.
+static bool checkSnapshots(PhysicsEngine &physics, int firstLevel, int lastLevel, int warmupTicks, int ticks)
+{
+    // Comfortably more than any built-in level needs (about 5-10 KB)
+    static const int32 STATE_BYTES = 64 * 1024;
+    static uint64_t storage[STATE_BYTES / sizeof(uint64_t)];
+    void *state = storage;
+
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        if (!loadLevel(physics, id))
+            continue;
+        int16_t x, y;
+        for (int tick = 0; tick < warmupTicks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+        }
+
+        int32 size = physics.saveState(state, STATE_BYTES);
+        if (size == 0) {
+            std::printf("level %d: FAILED, state does not fit in %d bytes\n", id, STATE_BYTES);
+            ok = false;
+            continue;
+        }
+
+        b2Vec2 first[2];
+        float angle[2];
+        for (int run = 0; run < 2; ++run) {
+            if (run == 1 && !physics.restoreState(state, size)) {
+                std::printf("level %d: FAILED, restore rejected the snapshot\n", id);
+                return false;
+            }
+            for (int tick = warmupTicks; tick < warmupTicks + ticks; ++tick) {
+                scriptedInput(tick, x, y);
+                physics.stepWithInput(x, y);
+            }
+            first[run] = physics.getBallPosition();
+            angle[run] = physics.getBallAngle();
+        }
+
+        const int rounds = 1000;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+            size = physics.saveState(state, STATE_BYTES);
+        std::chrono::steady_clock::time_point mid = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+            if (!physics.restoreState(state, size))
+                return false;
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        double saveUs = std::chrono::duration<double, std::micro>(mid - start).count() / rounds;
+        double restoreUs = std::chrono::duration<double, std::micro>(end - mid).count() / rounds;
+
+        bool same = std::memcmp(&first[0], &first[1], sizeof(b2Vec2)) == 0 &&
+                    std::memcmp(&angle[0], &angle[1], sizeof(float)) == 0;
+        std::printf("level %d: %s, %d byte snapshot, save %.2f us, restore %.2f us\n", id,
+                    same ? "restore reproduces the run" : "FAILED, runs diverge after restore", size, saveUs,
+                    restoreUs);
+        ok = ok && same;
+    }
+    return ok;
+}
+
+// Lets the ball settle with no tilt, then compares stepping the resting world
+// (what the game did every frame) with the idle check that replaces it. The
+// world must not change while resting, or skipping those ticks would not be
+// exact.
+static bool benchIdle(PhysicsEngine &physics, int firstLevel, int lastLevel, int warmupTicks, int ticks)
+{
+    const int maxSettleTicks = 60 * physics.getTickRate();
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        if (!loadLevel(physics, id))
+            continue;
+
+        int16_t x, y;
+        for (int tick = 0; tick < warmupTicks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+        }
+        int settle = 0;
+        while (!physics.isAtRest() && settle < maxSettleTicks) {
+            physics.stepWithInput(0, 0);
+            settle++;
+        }
+        if (!physics.isAtRest()) {
+            std::printf("level %d: never at rest (moving water or a ball that keeps rolling)\n", id);
+            continue;
+        }
+
+        b2WorldHash before, after;
+        physics.getStateHash(&before);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; ++tick)
+            physics.stepWithInput(0, 0);
+        double stepUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        physics.getStateHash(&after);
+
+        int skipped = 0;
+        start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; ++tick)
+            skipped += physics.isAtRest() && !physics.tiltWakes(0, 0);
+        double idleUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        bool same = before == after && physics.isAtRest() && skipped == ticks;
+        std::printf("level %d: %s; at rest after %d ticks, stepping at rest %.2f us/tick, idle check %.1f ns/tick\n",
+                    id, same ? "resting world is unchanged by steps" : "FAILED, resting world changed", settle,
+                    ticks ? stepUs / ticks : 0.0, ticks ? 1000.0 * idleUs / ticks : 0.0);
+        ok = ok && same;
+    }
+    return ok;
+}
+
+// Runs the scripted levels in real time on a FrameClock, like the game loop,
+// and reports how late each tick started
+static bool benchClock(PhysicsEngine &physics, int firstLevel, int lastLevel, int ticks)
+{
+    FrameClock clock;
+    if (!clock.start(1000000000LL / physics.getTickRate()))
+        return false;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        if (!loadLevel(physics, id))
+            continue;
+        clock.resetStats();
+        int16_t x, y;
+        for (int tick = 0; tick < ticks; ++tick) {
+            clock.wait();
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "level %d", id);
+        clock.report(std::cout, name);
+    }
+    return true;
+}
+
+// Times building each level against borrowing its cached template, and checks
+// that a run on a template another run already used matches a fresh build
+static bool benchCache(PhysicsEngine &physics, int firstLevel, int lastLevel, int warmupTicks, int ticks)
+{
+    const int rounds = 200;
+    LevelCache cache;
+    prepareCache(cache, firstLevel, lastLevel);
+    cache.wait();
+    cache.report(std::cout, "background build");
+
+    PhysicsEngine cached(false);
+    cached.setAdaptiveStepping(physics.isAdaptiveStepping());
+    cached.setTickRate(physics.getTickRate());
+    cached.setLevelCache(&cache);
+
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        LevelView level;
+        if (!findLevel(id, level))
+            continue;
+
+        // The first build of a level touches memory the later ones reuse
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        physics.loadLevel(level);
+        double firstUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+            physics.loadLevel(level);
+        double buildUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        cache.resetStats();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+            cached.loadLevel(level);
+        double cachedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        bool allHits = cache.stats().hits == static_cast<uint64_t>(rounds);
+
+        // Two runs on the template (the second starts from a used world)
+        // against one on a freshly built world
+        b2WorldHash fresh, reused;
+        int16_t x, y;
+        for (int run = 0; run < 3; ++run) {
+            PhysicsEngine &engine = run == 0 ? physics : cached;
+            engine.loadLevel(level);
+            for (int tick = 0; tick < warmupTicks + ticks; ++tick) {
+                scriptedInput(tick, x, y);
+                engine.stepWithInput(x, y);
+            }
+            engine.getStateHash(run == 0 ? &fresh : &reused);
+        }
+        bool same = allHits && fresh == reused;
+        std::printf("level %d: first build %.1f us, rebuild %.2f us, from cache %.2f us; %s\n", id, firstUs,
+                    buildUs / rounds, cachedUs / rounds,
+                    !allHits ? "FAILED, cache missed"
+                             : same ? "rerun on a reused template matches a fresh build"
+                                    : "FAILED, reused template diverges from a fresh build");
+        ok = ok && same;
+    }
+
+    // With a limit the cache keeps the levels built or borrowed last
+    cached.setLevelCache(nullptr);
+    LevelCache small(2);
+    prepareCache(small, firstLevel, lastLevel);
+    small.wait();
+    cached.setLevelCache(&small);
+    LevelView first, last;
+    if (findLevel(firstLevel, first) && findLevel(lastLevel, last) && lastLevel - firstLevel >= 2) {
+        cached.loadLevel(last);
+        cached.loadLevel(first);
+        LevelCache::Stats s = small.stats();
+        bool kept = s.hits == 1 && s.misses == 1 && s.evicted == s.templates - 2;
+        std::printf("limit 2: %d templates built, %d evicted, level %d kept, level %d dropped; %s\n", s.templates,
+                    s.evicted, lastLevel, firstLevel, kept ? "ok" : "FAILED, wrong templates kept");
+        ok = ok && kept;
+    }
+    cached.setLevelCache(nullptr);
+    return ok;
+}
+
+// Environment-steps per second of a BatchEnv: `count` environments on 1, 2,
+// 4, ... threads up to the core count, then fewer environments on all cores.
+// Each environment gets the script at its own offset; the last one must end
+// exactly where a lone engine fed the same inputs does.
+static bool benchBatch(PhysicsEngine &physics, int count, int firstLevel, int lastLevel, int ticks)
+{
+    int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<std::pair<int, int> > runs; // environments, threads
+    for (int threads = 1; threads < cores; threads *= 2)
+        runs.push_back(std::make_pair(count, threads));
+    runs.push_back(std::make_pair(count, cores));
+    for (int size = count / 64; size >= 1 && size < count; size *= 4)
+        runs.push_back(std::make_pair(size, cores));
+
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        LevelView level;
+        if (!findLevel(id, level))
+            continue;
+
+        double oneThread = 0.0;
+        for (const std::pair<int, int> &run : runs) {
+            BatchEnv batch(run.first, run.second);
+            batch.setAdaptiveStepping(physics.isAdaptiveStepping());
+            batch.setTickRate(physics.getTickRate());
+            batch.loadLevel(level);
+
+            std::vector<int16_t> inputs(2 * batch.size());
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks; ++tick) {
+                for (int env = 0; env < batch.size(); ++env)
+                    scriptedInput(tick + env * 37, inputs[2 * env], inputs[2 * env + 1]);
+                batch.step(inputs.data());
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double rate = seconds > 0.0 ? double(batch.size()) * ticks / seconds : 0.0;
+            if (run.first == count && run.second == 1)
+                oneThread = rate;
+            std::printf("batch level %d: %d envs on %d thread%s, %.2f M env-steps/s (%.2f us each)", id,
+                        batch.size(), batch.threadCount(), batch.threadCount() == 1 ? "" : "s", rate / 1e6,
+                        rate > 0.0 ? 1e6 / rate : 0.0);
+            if (run.first == count && run.second > 1 && oneThread > 0.0)
+                std::printf(", %.1fx one thread", rate / oneThread);
+            std::printf("\n");
+
+            if (run.first != count || run.second != cores)
+                continue;
+            int last = batch.size() - 1;
+            physics.loadLevel(level);
+            int16_t x, y;
+            for (int tick = 0; tick < ticks; ++tick) {
+                scriptedInput(tick + last * 37, x, y);
+                physics.stepWithInput(x, y);
+            }
+            b2WorldHash lone, batched;
+            physics.getStateHash(&lone);
+            batch.engine(last).getStateHash(&batched);
+            if (!(lone == batched)) {
+                std::printf("batch level %d: FAILED, env %d diverges from a lone engine\n", id, last);
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+// Flow field per level: build time and size, the distance from the start
+// against a straight line, and the cost of a lookup at positions from the
+// scripted run. Following direction() from the start must reach the hole,
+// and a background build must give the same field.
+static bool benchFlow(PhysicsEngine &physics, int firstLevel, int lastLevel, int ticks)
+{
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        LevelView view;
+        if (!findLevel(id, view))
+            continue;
+        LevelConfig level;
+        LevelData::assign(level, view);
+
+        FlowField field;
+        field.build(level);
+        // A second request supersedes the first, whether queued or running
+        FlowField background;
+        LevelConfig other;
+        LevelData::assign(other, LevelData::builtin(id == 1 ? 2 : 1));
+        background.buildAsync(other);
+        background.buildAsync(level);
+        background.wait();
+
+        // Walk the field one cell at a time until it stops
+        b2Vec2 p = level.ballStartPos;
+        int steps = 0;
+        const int maxSteps = 4 * field.columns() * field.rowCount();
+        for (b2Vec2 dir = field.direction(p); dir.LengthSquared() > 0.0f && steps < maxSteps;
+             dir = field.direction(p), ++steps)
+            p += FlowField::CELL * dir;
+        bool reached = (p - level.holePos).Length() < level.holeRadius + FlowField::CELL;
+
+        bool same = background.ready() && background.levelId() == level.id;
+        for (int r = 0; same && r < field.rowCount(); ++r) {
+            for (int c = 0; same && c < field.columns(); ++c) {
+                b2Vec2 q((c + 0.5f) * FlowField::CELL, (r + 0.5f) * FlowField::CELL);
+                same = field.distance(q) == background.distance(q) &&
+                       field.safeDistance(q) == background.safeDistance(q);
+            }
+        }
+
+        // Lookups along the scripted run
+        std::vector<b2Vec2> positions;
+        positions.reserve(ticks);
+        physics.loadLevel(view);
+        int16_t x, y;
+        for (int tick = 0; tick < ticks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+            positions.push_back(physics.getBallPosition());
+        }
+        const int rounds = 200;
+        float sum = 0.0f;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            for (const b2Vec2 &q : positions)
+                sum += field.distance(q);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        double perLookup = positions.empty() ? 0.0 : ns / (double(rounds) * positions.size());
+
+        float straight = (level.ballStartPos - level.holePos).Length();
+        float safe = field.safeDistance(level.ballStartPos);
+        std::printf("flow level %d: %dx%d cells, %zu bytes, built in %.2f ms; start %.2f m to the hole "
+                    "(straight %.2f m), %s; %.1f ns/lookup (sum %.0f)\n",
+                    id, field.columns(), field.rowCount(), field.bytes(), field.buildNs() / 1e6,
+                    field.distance(level.ballStartPos), straight,
+                    safe >= 0.0f ? "clear of moving water" : "no way round moving water", perLookup, sum);
+        if (!reached) {
+            std::printf("flow level %d: FAILED, following the field stops %.2f m from the hole\n", id,
+                        (p - level.holePos).Length());
+            ok = false;
+        }
+        if (!same) {
+            std::printf("flow level %d: FAILED, background build differs\n", id);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Re-run the prediction on the live engine itself: hold its last tilt and
+// sample the ball exactly as Prediction does, then put the engine back.
+static bool predictionMatches(PhysicsEngine &physics, const Prediction &prediction, std::vector<uint64_t> &buffer)
+{
+    int32 capacity = static_cast<int32>(buffer.size() * sizeof(uint64_t));
+    int32 size = physics.saveState(buffer.data(), capacity);
+    if (size == 0)
+        return false;
+
+    int16_t x = physics.getLastInputX(), y = physics.getLastInputY();
+    int stride = std::max(1, physics.getTickRate() / prediction.options().pointsPerSecond);
+    uint32_t respawns = physics.getRespawnCount();
+    bool same = prediction.pointCount() > 0 && prediction.points()[0] == physics.getBallPosition();
+    int ticks = prediction.pointCount() > 0 ? 1 : 0;
+    for (int tick = 1; same && ticks < prediction.pointCount(); ++tick) {
+        physics.stepWithInput(x, y);
+        b2Vec2 p = physics.getBallPosition();
+        if (physics.getRespawnCount() != respawns)
+            p = physics.getHazardEntryPoint();
+        else if (!physics.isBallInHole() && tick % stride != 0)
+            continue;
+        same = prediction.points()[ticks++] == p;
+    }
+    physics.restoreState(buffer.data(), size);
+    return same;
+}
+
+// Cost of the ghost path per frame: a prediction after every tick of the
+// scripted run, and every second one checked against the real run under
+// the same held tilt. The run itself must end exactly as it does without
+// predictions.
+static bool benchPrediction(PhysicsEngine &physics, int firstLevel, int lastLevel, int warmupTicks, int ticks)
+{
+    bool ok = true;
+    std::vector<uint64_t> buffer(64 * 1024 / sizeof(uint64_t));
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        if (!loadLevel(physics, id))
+            continue;
+        Prediction prediction;
+        int checked = 0, matched = 0, points = 0, endings[5] = {0, 0, 0, 0, 0};
+        int16_t x, y;
+        for (int tick = 0; tick < warmupTicks + ticks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+            if (tick == warmupTicks) {
+                prediction.resetStats();
+                AllocTracker::begin();
+            }
+            prediction.update(physics);
+            if (tick < warmupTicks)
+                continue;
+            points += prediction.pointCount();
+            endings[prediction.ending()]++;
+            if (tick % physics.getTickRate() == 0) {
+                AllocTracker::end();
+                checked++;
+                matched += predictionMatches(physics, prediction, buffer);
+                AllocTracker::begin();
+            }
+        }
+        AllocTracker::end();
+
+        b2WorldHash predicted, plain;
+        physics.getStateHash(&predicted);
+        loadLevel(physics, id);
+        for (int tick = 0; tick < warmupTicks + ticks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+        }
+        physics.getStateHash(&plain);
+
+        Prediction::Stats s = prediction.stats();
+        double meanUs = s.updates ? s.totalNs / 1000.0 / s.updates : 0.0;
+        double frameUs = 1e6 / physics.getTickRate();
+        std::printf("predict level %d: mean %.1f us (max %.1f us, %.1f%% of a frame), %.1f ticks and %.1f points "
+                    "ahead; %d to the horizon, %d into water, %d into the hole, %d cut by the budget, %d at rest\n",
+                    id, meanUs, s.maxNs / 1000.0, 100.0 * meanUs / frameUs,
+                    s.updates ? double(s.ticks) / s.updates : 0.0, double(points) / ticks,
+                    endings[Prediction::RUNNING], endings[Prediction::WATER], endings[Prediction::HOLE],
+                    endings[Prediction::BUDGET], endings[Prediction::RESTING]);
+        if (!(predicted == plain)) {
+            std::printf("predict level %d: FAILED, predicting changes the run\n", id);
+            ok = false;
+        }
+        if (matched != checked) {
+            std::printf("predict level %d: FAILED, %d of %d predictions differ from the held-tilt run\n", id,
+                        checked - matched, checked);
+            ok = false;
+        }
+        if (AllocTracker::enabled() && AllocTracker::count() > 0) {
+            std::printf("predict level %d: FAILED, %llu allocations\n", id, (unsigned long long)AllocTracker::count());
+            AllocTracker::report();
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Time the per-tick history capture and rewinding, and check that a rewind
+// followed by the same inputs lands exactly where the first run did.
+static bool benchRewind(PhysicsEngine &physics, int firstLevel, int lastLevel, int warmupTicks, int ticks)
+{
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        RewindBuffer history;
+        if (!loadLevel(physics, id))
+            continue;
+        // Begin on the fresh level, then capture by hand so only capture is timed
+        physics.setRewindBuffer(&history);
+        physics.setRewindBuffer(nullptr);
+
+        int16_t x, y;
+        double captureNs = 0.0;
+        int total = warmupTicks + ticks;
+        for (int tick = 0; tick < total; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            history.capture(physics);
+            captureNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        b2Vec2 pos = physics.getBallPosition();
+        float angle = physics.getBallAngle();
+
+        // Go back, then replay the same inputs
+        int back = ticks < history.available() ? ticks : history.available();
+        uint32_t respawns = physics.getRespawnCount();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool rewound = history.rewind(physics, back);
+        double rewindUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        // Water hits between the keyframe and the target are not counted twice
+        rewound = rewound && physics.getRespawnCount() == respawns;
+        for (int tick = total - back; tick < total; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+            history.capture(physics);
+        }
+        b2Vec2 again = physics.getBallPosition();
+        float againAngle = physics.getBallAngle();
+        bool same = rewound && std::memcmp(&pos, &again, sizeof(pos)) == 0 &&
+                    std::memcmp(&angle, &againAngle, sizeof(angle)) == 0;
+
+        // Scrubbing: one tick back per frame
+        const int scrubs = 120;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < scrubs; ++i)
+            history.rewind(physics, 1);
+        double scrubUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / scrubs;
+
+        std::printf("level %d: %s; capture %.0f ns/tick, rewind %d ticks %.1f us, scrub %.1f us/frame, "
+                    "%.1f s of history in %zu KB (%zu byte keyframes)\n",
+                    id, same ? "rewind reproduces the run" : "FAILED, rewound run diverges", captureNs / total, back,
+                    rewindUs, scrubUs, history.capacity() / float(physics.getTickRate()), history.budgetBytes() / 1024,
+                    history.keyframeBytes());
+        ok = ok && same;
+
+        // Holding rewind on a small ring that has wrapped: it must stop at the
+        // oldest tick still held, and every tick on the way must be the one
+        // that was played
+        RewindBuffer ring(20 * 1024);
+        loadLevel(physics, id);
+        physics.setRewindBuffer(&ring);
+        physics.setRewindBuffer(nullptr);
+        std::vector<b2Vec2> played(1, physics.getBallPosition());
+        int wrapTicks = 3 * ring.capacity() + 7;
+        for (int tick = 0; tick < wrapTicks; ++tick) {
+            scriptedInput(tick, x, y);
+            physics.stepWithInput(x, y);
+            ring.capture(physics);
+            played.push_back(physics.getBallPosition());
+        }
+        int held = ring.available();
+        int steps = 0, wrong = 0;
+        while (ring.rewind(physics, 1)) {
+            ++steps;
+            b2Vec2 p = physics.getBallPosition();
+            if (steps >= static_cast<int>(played.size()) ||
+                std::memcmp(&p, &played[played.size() - 1 - steps], sizeof(p)) != 0)
+                wrong++;
+        }
+        bool stops = steps == held && wrong == 0 && ring.available() == 0;
+        std::printf("level %d: %s; held rewind on a %d-tick ring went back %d of %d ticks, %d wrong\n", id,
+                    stops ? "held rewind stops at the oldest tick" : "FAILED, held rewind leaves the history",
+                    ring.capacity(), steps, held, wrong);
+        ok = ok && stops;
+    }
+    return ok;
+}
+
+// Per-tick b2WorldHash stream ("TGHS", then 4 little-endian u64 per tick),
+// for comparing the same run on two machines with --compare-hashes.
+class HashLog {
+public:
+    HashLog() : file(nullptr), ticks(0), hashNs(0.0) {}
+    ~HashLog() { close(); }
+
+    bool open(const char *path)
+    {
+        file = std::fopen(path, "wb");
+        if (!file) {
+            std::fprintf(stderr, "headless: cannot write %s\n", path);
+            return false;
+        }
+        std::fwrite(HASH_MAGIC, 1, 4, file);
+        return true;
+    }
+
+    void add(const PhysicsEngine &physics)
+    {
+        if (!file)
+            return;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        b2WorldHash hash;
+        physics.getStateHash(&hash);
+        hashNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        const uint64_t fields[4] = {hash.transforms, hash.velocities, hash.contacts, hash.sleep};
+        uint8_t bytes[32];
+        for (int f = 0; f < 4; ++f)
+            for (int i = 0; i < 8; ++i)
+                bytes[f * 8 + i] = static_cast<uint8_t>(fields[f] >> (8 * i));
+        std::fwrite(bytes, 1, sizeof(bytes), file);
+        ticks++;
+    }
+
+    void close()
+    {
+        if (!file)
+            return;
+        std::fclose(file);
+        file = nullptr;
+        std::printf("hash log: %llu ticks, %.0f ns/tick to hash\n", (unsigned long long)ticks,
+                    ticks ? hashNs / ticks : 0.0);
+    }
+
+    static const char HASH_MAGIC[5];
+
+private:
+    FILE *file;
+    uint64_t ticks;
+    double hashNs;
+};
+
+const char HashLog::HASH_MAGIC[5] = "TGHS";
+
+// --bot: longest a level may take before it counts as failed
+static const int BOT_SECONDS = 180;
+
+// Play the loaded level with the bot instead of the script, until the ball is
+// in the hole. Recording, trajectories and hash logs work as for the script.
+static bool playBot(PhysicsEngine &physics, int id, TrajectoryWriter &trajectory, HashLog &hashes)
+{
+    TiltBot bot(physics.getLevelConfig());
+    if (!bot.hasPath()) {
+        std::printf("level %d: bot FAILED, no path to the hole\n", id);
+        return false;
+    }
+
+    int maxTicks = BOT_SECONDS * physics.getTickRate();
+    uint32_t respawns = physics.getRespawnCount();
+    double stepUs = 0.0;
+    int tick = 0;
+    bool holed = false;
+    int16_t x, y;
+    while (!holed && tick < maxTicks) {
+        bot.nextInput(physics, x, y);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        physics.stepWithInput(x, y);
+        stepUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        trajectory.addFrame(physics);
+        hashes.add(physics);
+        holed = physics.isBallInHole();
+        tick++;
+    }
+
+    double rate = physics.getTickRate();
+    if (!holed) {
+        b2Vec2 pos = physics.getBallPosition();
+        std::printf("level %d: bot FAILED, ball at (%.3f, %.3f) after %d s, %u respawns\n", id, pos.x, pos.y,
+                    BOT_SECONDS, physics.getRespawnCount() - respawns);
+        return false;
+    }
+    std::printf("level %d: bot in the hole after %d ticks (%.1f s, path %.1f m), %.2f us/tick, %u respawns, "
+                "%.1f s waiting for water, %.1f s recovering\n",
+                id, tick, tick / rate, bot.pathLength(), stepUs / tick, physics.getRespawnCount() - respawns,
+                bot.waitingTicks() / rate, bot.recoveringTicks() / rate);
+    return true;
+}
+
+// Report the first tick and field where two hash logs differ.
+static bool compareHashes(const char *pathA, const char *pathB)
+{
+    static const char *const FIELDS[4] = {"transforms", "velocities", "contacts", "sleep"};
+    FILE *a = std::fopen(pathA, "rb");
+    FILE *b = std::fopen(pathB, "rb");
+    char magicA[4] = {0}, magicB[4] = {0};
+    if (!a || !b || std::fread(magicA, 1, 4, a) != 4 || std::fread(magicB, 1, 4, b) != 4 ||
+        std::memcmp(magicA, HashLog::HASH_MAGIC, 4) || std::memcmp(magicB, HashLog::HASH_MAGIC, 4)) {
+        std::fprintf(stderr, "headless: %s and %s must both be hash logs\n", pathA, pathB);
+        if (a) std::fclose(a);
+        if (b) std::fclose(b);
+        return false;
+    }
+
+    uint8_t ra[32], rb[32];
+    uint64_t tick = 0;
+    bool same = true;
+    for (;; ++tick) {
+        size_t na = std::fread(ra, 1, sizeof(ra), a);
+        size_t nb = std::fread(rb, 1, sizeof(rb), b);
+        if (na != sizeof(ra) || nb != sizeof(rb)) {
+            if (na != nb) {
+                std::printf("hashes: logs differ in length, one ends at tick %llu\n", (unsigned long long)tick);
+                same = false;
+            }
+            break;
+        }
+        if (std::memcmp(ra, rb, sizeof(ra)) != 0) {
+            std::printf("hashes: first divergence at tick %llu in", (unsigned long long)tick);
+            for (int f = 0; f < 4; ++f)
+                if (std::memcmp(ra + f * 8, rb + f * 8, 8) != 0)
+                    std::printf(" %s", FIELDS[f]);
+            std::printf("\n");
+            same = false;
+            break;
+        }
+    }
+    std::fclose(a);
+    std::fclose(b);
+    if (same)
+        std::printf("hashes: %llu ticks identical\n", (unsigned long long)tick);
+    return same;
+}
+
+// Re-drive a recorded run as fast as possible and verify its checkpoints.
+static bool runReplay(PhysicsEngine &physics, const char *path, HashLog &hashes)
+{
+    ReplayPlayer player;
+    if (!player.open(path))
+        return false;
+    if (levelPack.isOpen())
+        player.setLevelPack(&levelPack);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (player.nextTick(physics))
+        hashes.add(physics);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double simulated = double(player.tick()) / physics.getTickRate();
+    std::printf("replay %s: %llu ticks (%.1f s of play) in %.3f s, %.0fx real time\n", path,
+                (unsigned long long)player.tick(), simulated, seconds, seconds > 0.0 ? simulated / seconds : 0.0);
+    if (player.mismatchCount() > 0) {
+        std::printf("replay %s: DIVERGED, %d of %d checkpoints differ (first at tick %lld)\n", path,
+                    player.mismatchCount(), player.checkpointCount(), (long long)player.firstMismatchTick());
+        return false;
+    }
+    std::printf("replay %s: %d checkpoints match bit for bit\n", path, player.checkpointCount());
+    return true;
+}
+
+// Decode a whole trajectory from the mapping, then check seeking into it.
+static bool readTrajectory(const char *path)
+{
+    TrajectoryReader reader;
+    if (!reader.open(path))
+        return false;
+
+    TrajectoryFrame frame;
+    uint64_t decoded = 0, respawns = 0, contacts = 0;
+    float checksum = 0.0f;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (reader.next(frame)) {
+        decoded++;
+        respawns += (frame.events & TRAJ_EVENT_RESPAWN) != 0;
+        contacts += (frame.events & TRAJ_EVENT_CONTACT) != 0;
+        checksum += frame.x + frame.y;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (decoded != reader.frameCount()) {
+        std::printf("trajectory %s: FAILED, decoded %llu of %llu frames\n", path,
+                    (unsigned long long)decoded, (unsigned long long)reader.frameCount());
+        return false;
+    }
+
+    double rawBytes = double(decoded) * TrajectoryReader::RAW_FRAME_BYTES;
+    std::printf("trajectory %s: %llu frames in %u blocks, %llu respawns, %llu contacts (checksum %.3f)\n", path,
+                (unsigned long long)decoded, reader.blockCount(), (unsigned long long)respawns,
+                (unsigned long long)contacts, checksum);
+    std::printf("trajectory %s: %zu bytes, %.2f bytes/frame, %.1fx smaller than raw frames\n", path,
+                reader.fileBytes(), decoded ? double(reader.fileBytes()) / decoded : 0.0,
+                reader.fileBytes() ? rawBytes / reader.fileBytes() : 0.0);
+    if (seconds > 0.0)
+        std::printf("trajectory %s: decoded at %.1f M frames/s (%.0f MB/s of raw frames)\n", path,
+                    decoded / seconds / 1e6, rawBytes / seconds / 1e6);
+
+    // Random access must land on the same frame as a sequential decode
+    if (decoded > 0) {
+        uint64_t target = decoded * 2 / 3;
+        TrajectoryFrame sequential, sought;
+        reader.seek(0);
+        for (uint64_t i = 0; i <= target; ++i)
+            reader.next(sequential);
+        if (!reader.seek(target) || !reader.next(sought) ||
+            std::memcmp(&sequential, &sought, sizeof(sought)) != 0) {
+            std::printf("trajectory %s: FAILED, seek to frame %llu disagrees with sequential decode\n", path,
+                        (unsigned long long)target);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Generate solvable levels on all cores and optionally store them as a pack.
+static bool generateLevels(int count, uint64_t seed, const LevelGenerator::Options &options, const char *packPath)
+{
+    LevelGenerator generator(seed);
+    LevelGenerator::Stats stats;
+    std::vector<GeneratedLevel> levels = generator.generate(count, 1, options, &stats);
+
+    for (const GeneratedLevel &g : levels)
+        std::printf("generated level %d: candidate %u, %zu walls, %zu water, %zu moving water, bot in %.1f s "
+                    "(rollout %d)\n",
+                    g.level.id, g.candidate, g.level.walls.size() - 4, g.level.water.size(),
+                    g.level.movingWater.size(), double(g.botTicks) / options.tickRate, g.rollouts);
+    std::printf("generator: %zu levels from %llu candidates (%llu bad placement, %llu no path, %llu unsolved) "
+                "in %.2f s on %d threads\n",
+                levels.size(), (unsigned long long)stats.candidates, (unsigned long long)stats.badPlacement,
+                (unsigned long long)stats.noPath, (unsigned long long)stats.unsolved, stats.seconds, stats.threads);
+    if (stats.seconds > 0.0)
+        std::printf("generator: %.1f levels/s, %.1f candidates/s, %llu bot rollouts at %.0f ticks/s\n",
+                    levels.size() / stats.seconds, stats.candidates / stats.seconds,
+                    (unsigned long long)stats.rollouts, stats.ticks / stats.seconds);
+
+    if (packPath) {
+        std::vector<LevelConfig> configs;
+        for (const GeneratedLevel &g : levels)
+            configs.push_back(g.level);
+        if (!LevelPack::write(packPath, configs))
+            return false;
+        std::printf("generator: wrote %zu levels to %s\n", configs.size(), packPath);
+    }
+    return static_cast<int>(levels.size()) == count;
+}
+
+// --rate: Monte Carlo rating of each level. Prints the rating as levelc
+// source and as the built-in table entry, and with --write-pack stores the
+// rated levels as a pack.
+static bool rateLevels(int firstLevel, int lastLevel, const Difficulty::Options &options, const char *packPath)
+{
+    std::vector<LevelConfig> rated;
+    bool ok = true;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        LevelView view;
+        if (!findLevel(id, view))
+            continue;
+        Difficulty::Result result = Difficulty::estimate(view, options);
+        Difficulty::report(std::cout, result);
+        const LevelRating &r = result.rating;
+        std::printf("level %d: rating %.0f %.3f %.2f  (levelc source), {%.1ff, %.3ff, %.2ff} (LevelData.cpp)\n", id,
+                    r.parSeconds, r.successRate, r.medianSeconds, r.parSeconds, r.successRate, r.medianSeconds);
+        ok = ok && result.hasPath && r.parSeconds > 0.0f;
+
+        rated.push_back(LevelConfig());
+        LevelData::assign(rated.back(), view);
+        rated.back().rating = r;
+    }
+    if (packPath) {
+        if (!LevelPack::write(packPath, rated))
+            return false;
+        std::printf("rate: wrote %zu rated levels to %s\n", rated.size(), packPath);
+    }
+    return ok;
+}
+
+static void usage()
+{
+    std::fprintf(stderr,
+                 "usage: headless [options]\n"
+                 "  --level N        only run level N (default: all)\n"
+                 "  --ticks N        ticks per level (default: 600)\n"
+                 "  --warmup N       ticks before checks start (default: 120)\n"
+                 "  --adaptive       adaptive substepping instead of one fixed step per tick\n"
+                 "  --tick-rate N    physics ticks per second (default: 60)\n"
+                 "  --levels PACK    run the levels of a compiled pack (tools/levelc) instead\n"
+                 "  --level-cache    load levels from prebuilt templates (as the game does)\n"
+                 "  --check-allocs   fail if a tick allocates after warm-up\n"
+                 "  --check-snapshot fail if restoring a mid-level snapshot changes the run\n"
+                 "  --rewind-bench   time history capture and rewind, verify rewound reruns\n"
+                 "  --clock-bench    run in real time on the frame clock, report tick lateness\n"
+                 "  --batch-bench N  step N environments per level on 1..all cores, report env-steps/s\n"
+                 "  --cache-bench    time level builds vs cached templates, verify reuse is exact\n"
+                 "  --predict-bench  time the ghost path after every tick, verify it against the real run\n"
+                 "  --flow-bench     build each level's flow field, report size and lookup cost, follow it\n"
+                 "  --rt             apply the real-time profile first (as TILTGOLF_RT=1 in the game)\n"
+                 "  --bot            play each level with the bot until the ball is in the hole\n"
+                 "  --generate N     generate N bot-verified levels (--seed S, --threads T, --par SECONDS,\n"
+                 "                   --rollouts R, --write-pack FILE)\n"
+                 "  --rate           par, success rate and median time per level from noisy bot rollouts\n"
+                 "                   (--rollouts R, --noise MAX, --seed S, --threads T, --write-pack FILE)\n"
+                 "  --idle-bench     time a resting ball stepped vs skipped, verify skipping is exact\n"
+                 "  --trace FILE     write profiling zones as Chrome trace JSON\n"
+                 "  --record FILE    log the scripted (or bot) run for replay\n"
+                 "  --replay FILE    re-run a recorded log (from here or the game) and verify it\n"
+                 "  --trajectory FILE  store the scripted run's ball trajectory\n"
+                 "  --read-trajectory FILE  decode a trajectory and report size and speed\n"
+                 "  --hash-log FILE  write a per-tick world state hash (scripted run or --replay)\n"
+                 "  --compare-hashes A B  report the first tick and field where two hash logs differ\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int firstLevel = 1;
+    int lastLevel = NUM_LEVELS;
+    bool levelChosen = false;
+    const char *levelPackPath = nullptr;
+    int ticks = 600;
+    int warmupTicks = 120;
+    bool allocCheck = false;
+    bool snapshotCheck = false;
+    bool rewindBench = false;
+    bool idleBench = false;
+    bool clockBench = false;
+    bool cacheBench = false;
+    bool flowBench = false;
+    bool predictBench = false;
+    int batchSize = 0;
+    bool useCache = false;
+    bool realtime = false;
+    bool adaptive = false;
+    bool botPlays = false;
+    const char *tracePath = nullptr;
+    const char *recordPath = nullptr;
+    const char *replayPath = nullptr;
+    const char *trajectoryPath = nullptr;
+    const char *readTrajectoryPath = nullptr;
+    const char *hashLogPath = nullptr;
+    const char *compareA = nullptr;
+    const char *compareB = nullptr;
+    int generateCount = 0;
+    uint64_t generateSeed = 1;
+    LevelGenerator::Options generateOptions;
+    bool rate = false;
+    Difficulty::Options rateOptions;
+    const char *writePackPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(arg, "--level") && hasValue) {
+            firstLevel = lastLevel = std::atoi(argv[++i]);
+            levelChosen = true;
+        } else if (!std::strcmp(arg, "--levels") && hasValue) {
+            levelPackPath = argv[++i];
+        } else if (!std::strcmp(arg, "--ticks") && hasValue) {
+            ticks = std::atoi(argv[++i]);
+        } else if (!std::strcmp(arg, "--warmup") && hasValue) {
+            warmupTicks = std::atoi(argv[++i]);
+        } else if (!std::strcmp(arg, "--check-allocs")) {
+            allocCheck = true;
+        } else if (!std::strcmp(arg, "--check-snapshot")) {
+            snapshotCheck = true;
+        } else if (!std::strcmp(arg, "--tick-rate") && hasValue) {
+            tickRate = std::atoi(argv[++i]);
+            if (tickRate <= 0) {
+                usage();
+                return 2;
+            }
+        } else if (!std::strcmp(arg, "--adaptive")) {
+            adaptive = true;
+        } else if (!std::strcmp(arg, "--rt")) {
+            realtime = true;
+        } else if (!std::strcmp(arg, "--clock-bench")) {
+            clockBench = true;
+        } else if (!std::strcmp(arg, "--cache-bench")) {
+            cacheBench = true;
+        } else if (!std::strcmp(arg, "--flow-bench")) {
+            flowBench = true;
+        } else if (!std::strcmp(arg, "--predict-bench")) {
+            predictBench = true;
+        } else if (!std::strcmp(arg, "--batch-bench") && hasValue) {
+            batchSize = std::atoi(argv[++i]);
+        } else if (!std::strcmp(arg, "--level-cache")) {
+            useCache = true;
+        } else if (!std::strcmp(arg, "--idle-bench")) {
+            idleBench = true;
+        } else if (!std::strcmp(arg, "--rewind-bench")) {
+            rewindBench = true;
+        } else if (!std::strcmp(arg, "--trace") && hasValue) {
+            tracePath = argv[++i];
+        } else if (!std::strcmp(arg, "--record") && hasValue) {
+            recordPath = argv[++i];
+        } else if (!std::strcmp(arg, "--replay") && hasValue) {
+            replayPath = argv[++i];
+        } else if (!std::strcmp(arg, "--trajectory") && hasValue) {
+            trajectoryPath = argv[++i];
+        } else if (!std::strcmp(arg, "--read-trajectory") && hasValue) {
+            readTrajectoryPath = argv[++i];
+        } else if (!std::strcmp(arg, "--hash-log") && hasValue) {
+            hashLogPath = argv[++i];
+        } else if (!std::strcmp(arg, "--bot")) {
+            botPlays = true;
+        } else if (!std::strcmp(arg, "--generate") && hasValue) {
+            generateCount = std::atoi(argv[++i]);
+        } else if (!std::strcmp(arg, "--seed") && hasValue) {
+            generateSeed = std::strtoull(argv[++i], nullptr, 0);
+            rateOptions.seed = generateSeed;
+        } else if (!std::strcmp(arg, "--threads") && hasValue) {
+            generateOptions.threads = std::atoi(argv[++i]);
+            rateOptions.threads = generateOptions.threads;
+        } else if (!std::strcmp(arg, "--par") && hasValue) {
+            generateOptions.parSeconds = static_cast<float>(std::atof(argv[++i]));
+        } else if (!std::strcmp(arg, "--rollouts") && hasValue) {
+            generateOptions.rollouts = std::atoi(argv[++i]);
+            rateOptions.rollouts = generateOptions.rollouts;
+        } else if (!std::strcmp(arg, "--rate")) {
+            rate = true;
+        } else if (!std::strcmp(arg, "--noise") && hasValue) {
+            rateOptions.maxNoise = std::atoi(argv[++i]);
+        } else if (!std::strcmp(arg, "--write-pack") && hasValue) {
+            writePackPath = argv[++i];
+        } else if (!std::strcmp(arg, "--compare-hashes") && i + 2 < argc) {
+            compareA = argv[++i];
+            compareB = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (tracePath && !Profiler::enabled()) {
+        std::fprintf(stderr, "headless: --trace needs the trace_zones build\n");
+        return 2;
+    }
+
+    if (readTrajectoryPath)
+        return readTrajectory(readTrajectoryPath) ? 0 : 1;
+    if (compareA)
+        return compareHashes(compareA, compareB) ? 0 : 1;
+    if (generateCount > 0) {
+        generateOptions.tickRate = tickRate;
+        return generateLevels(generateCount, generateSeed, generateOptions, writePackPath) ? 0 : 1;
+    }
+
+    if (levelPackPath) {
+        if (!levelPack.open(levelPackPath) || levelPack.count() == 0)
+            return 1;
+        if (!levelChosen) {
+            firstLevel = levelPack.idAt(0);
+            lastLevel = levelPack.idAt(levelPack.count() - 1);
+        }
+    }
+    if (rate) {
+        rateOptions.tickRate = tickRate;
+        return rateLevels(firstLevel, lastLevel, rateOptions, writePackPath) ? 0 : 1;
+    }
+
+    if (realtime)
+        RealtimeProfile::apply();
+
+    // Declared first: the engine hands its template back when destroyed
+    LevelCache cache;
+    PhysicsEngine physics(false);
+    physics.setAdaptiveStepping(adaptive);
+    physics.setTickRate(tickRate);
+
+    if (batchSize > 0)
+        return benchBatch(physics, batchSize, firstLevel, lastLevel, ticks) ? 0 : 1;
+    if (cacheBench)
+        return benchCache(physics, firstLevel, lastLevel, warmupTicks, ticks) ? 0 : 1;
+    if (flowBench)
+        return benchFlow(physics, firstLevel, lastLevel, ticks) ? 0 : 1;
+
+    if (useCache) {
+        prepareCache(cache, firstLevel, lastLevel);
+        cache.wait();
+        physics.setLevelCache(&cache);
+    }
+
+    if (allocCheck)
+        return checkAllocs(physics, firstLevel, lastLevel, warmupTicks, ticks) ? 0 : 1;
+    if (snapshotCheck)
+        return checkSnapshots(physics, firstLevel, lastLevel, warmupTicks, ticks) ? 0 : 1;
+    if (rewindBench)
+        return benchRewind(physics, firstLevel, lastLevel, warmupTicks, ticks) ? 0 : 1;
+    if (predictBench)
+        return benchPrediction(physics, firstLevel, lastLevel, warmupTicks, ticks) ? 0 : 1;
+    if (clockBench)
+        return benchClock(physics, firstLevel, lastLevel, ticks) ? 0 : 1;
+    if (idleBench)
+        return benchIdle(physics, firstLevel, lastLevel, warmupTicks, ticks) ? 0 : 1;
+
+    // Logs from the game may contain rewinds
+    RewindBuffer history;
+    physics.setRewindBuffer(&history);
+
+    HashLog hashes;
+    if (hashLogPath && !hashes.open(hashLogPath))
+        return 1;
+
+    if (replayPath) {
+        bool ok = runReplay(physics, replayPath, hashes);
+        if (tracePath)
+            Profiler::writeChromeTrace(tracePath);
+        return ok ? 0 : 1;
+    }
+
+    InputRecorder recorder;
+    if (recordPath) {
+        if (!recorder.open(recordPath))
+            return 1;
+        physics.setRecorder(&recorder);
+    }
+
+    TrajectoryWriter trajectory;
+    if (trajectoryPath && !trajectory.open(trajectoryPath))
+        return 1;
+
+    bool botFailed = false;
+    for (int id = firstLevel; id <= lastLevel; ++id) {
+        if (!loadLevel(physics, id))
+            continue;
+        if (botPlays) {
+            botFailed = !playBot(physics, id, trajectory, hashes) || botFailed;
+            continue;
+        }
+        int16_t x, y;
+        double stepUs = 0.0;
+        long substeps = 0;
+        uint32_t respawns = physics.getRespawnCount();
+        for (int tick = 0; tick < ticks; ++tick) {
+            scriptedInput(tick, x, y);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            physics.stepWithInput(x, y);
+            stepUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            substeps += physics.getLastSubsteps();
+            trajectory.addFrame(physics);
+            hashes.add(physics);
+        }
+        b2Vec2 pos = physics.getBallPosition();
+        std::printf("level %d: ball at (%.3f, %.3f) after %d ticks, %.2f us/tick, %.2f Box2D steps/tick, %u respawns\n",
+                    id, pos.x, pos.y, ticks, ticks ? stepUs / ticks : 0.0, ticks ? double(substeps) / ticks : 0.0,
+                    physics.getRespawnCount() - respawns);
+    }
+    physics.setRecorder(nullptr);
+    if (useCache)
+        cache.report(std::cout, "level cache");
+
+    if (trajectory.isOpen()) {
+        uint64_t frames = trajectory.frameCount();
+        if (!trajectory.close())
+            return 1;
+        std::printf("trajectory %s: %llu frames, %llu bytes (%.1fx smaller than raw frames)\n", trajectoryPath,
+                    (unsigned long long)frames, (unsigned long long)trajectory.bytesWritten(),
+                    double(frames) * TrajectoryReader::RAW_FRAME_BYTES / trajectory.bytesWritten());
+    }
+
+    if (tracePath && !Profiler::writeChromeTrace(tracePath)) {
+        std::fprintf(stderr, "headless: failed to write %s\n", tracePath);
+        return 1;
+    }
+    return botFailed ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+# Headless (no Qt, no display) runner for the physics layer.
+# Desktop build:  qmake headless.pro && make
+# Allocation-tracking build:  qmake "CONFIG += track_allocs" headless.pro && make
+
+TEMPLATE = app
+TARGET = headless
+CONFIG += console thread
+CONFIG -= qt app_bundle
+INCLUDEPATH += ..
+include(../Box2D.pri)
+LIBS += -lm
+
+trace_zones {
+    DEFINES += TILTGOLF_PROFILE B2_PROFILE_ZONES
+}
+
+track_allocs {
+    DEFINES += TILTGOLF_TRACK_ALLOCS B2_USER_SETTINGS
+    QMAKE_LFLAGS += -rdynamic # symbol names in call-site reports
+}
+
+HEADERS += ../PhysicsEngine.h ../LevelCache.h ../BackgroundWorker.h ../IMU.h ../LevelData.h ../AllocTracker.h ../b2_user_settings.h ../Profiler.h ../Replay.h ../Trajectory.h ../Rewind.h ../FrameClock.h ../RealtimeProfile.h ../LevelPack.h ../TiltBot.h ../GridSearch.h ../LevelGenerator.h ../BatchEnv.h ../FlowField.h ../Prediction.h ../Difficulty.h
+
+SOURCES += headless.cpp ../PhysicsEngine.cpp ../LevelCache.cpp ../BackgroundWorker.cpp ../LevelData.cpp ../IMU.cpp ../AllocTracker.cpp ../Profiler.cpp ../Replay.cpp ../Trajectory.cpp ../Rewind.cpp ../FrameClock.cpp ../RealtimeProfile.cpp ../LevelPack.cpp ../TiltBot.cpp ../GridSearch.cpp ../LevelGenerator.cpp ../BatchEnv.cpp ../FlowField.cpp ../Prediction.cpp ../Difficulty.cpp
@@ -0,0 +1,226 @@
+// Level compiler: turns level source files into a binary level pack
+// (LevelPack.h) that the game maps at startup.
+//
+// Source format, one directive per line, '#' starts a comment. All lengths
+// in metres, positions are centres, sizes are half extents:
+//
+//   level <id>                      starts a level; ids must be unique
+//   size <width> <height>           world size (default 31 x 15)
+//   border <halfThickness>          four boundary walls inside the world
+//   start <x> <y>                   ball start
+//   hole <x> <y> [radius]           hole (default radius 0.6)
+//   wall <x> <y> <hx> <hy>
+//   water <x> <y> <hx> <hy>
+//   moving <x> <y> <hx> <hy> <amplitude> <speed> [phase] [direction]
+//                                   water oscillating vertically around x, y
+//   rating <par> [success] [median] par time in seconds, success rate 0..1 and
+//                                   median time (headless --rate prints these)
+//
+//   levelc -o levels.tglp a.txt b.txt     compile
+//   levelc --export-builtin > builtin.txt the built-in levels as source
+//   levelc --list levels.tglp             summary of a pack
+
+#include "LevelData.h"
+#include "LevelPack.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static bool parseFile(const char *path, std::vector<LevelConfig> &levels)
+{
+    FILE *file = std::fopen(path, "r");
+    if (!file) {
+        std::fprintf(stderr, "levelc: cannot open %s\n", path);
+        return false;
+    }
+
+    bool ok = true;
+    LevelConfig *level = nullptr;
+    char buffer[512];
+    int lineNumber = 0;
+    while (ok && std::fgets(buffer, sizeof(buffer), file)) {
+        lineNumber++;
+        std::string line(buffer);
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream in(line);
+        std::string word;
+        if (!(in >> word))
+            continue;
+
+        std::vector<float> v;
+        float x;
+        while (in >> x)
+            v.push_back(x);
+        if (!in.eof()) {
+            std::fprintf(stderr, "%s:%d: expected numbers after '%s'\n", path, lineNumber, word.c_str());
+            ok = false;
+            break;
+        }
+
+        auto need = [&](size_t least, size_t most) {
+            if (v.size() >= least && v.size() <= most)
+                return true;
+            std::fprintf(stderr, "%s:%d: '%s' takes %zu to %zu values, got %zu\n", path, lineNumber, word.c_str(),
+                         least, most, v.size());
+            return false;
+        };
+
+        if (word == "level") {
+            if (!(ok = need(1, 1)))
+                break;
+            levels.push_back(LevelConfig());
+            level = &levels.back();
+            level->id = static_cast<int>(v[0]);
+            level->width = 31.0f;
+            level->height = 15.0f;
+            level->holeRadius = 0.6f;
+            level->ballStartPos.SetZero();
+            level->holePos.SetZero();
+            continue;
+        }
+        if (!level) {
+            std::fprintf(stderr, "%s:%d: '%s' before the first 'level'\n", path, lineNumber, word.c_str());
+            ok = false;
+            break;
+        }
+
+        if (word == "size" && (ok = need(2, 2))) {
+            level->width = v[0];
+            level->height = v[1];
+        } else if (word == "border" && (ok = need(1, 1))) {
+            float t = v[0], w = level->width, h = level->height;
+            level->walls.push_back({b2Vec2(w * 0.5f, t), b2Vec2(w * 0.5f, t)});
+            level->walls.push_back({b2Vec2(w * 0.5f, h - t), b2Vec2(w * 0.5f, t)});
+            level->walls.push_back({b2Vec2(t, h * 0.5f), b2Vec2(t, h * 0.5f)});
+            level->walls.push_back({b2Vec2(w - t, h * 0.5f), b2Vec2(t, h * 0.5f)});
+        } else if (word == "start" && (ok = need(2, 2))) {
+            level->ballStartPos.Set(v[0], v[1]);
+        } else if (word == "hole" && (ok = need(2, 3))) {
+            level->holePos.Set(v[0], v[1]);
+            if (v.size() > 2)
+                level->holeRadius = v[2];
+        } else if ((word == "wall" || word == "water") && (ok = need(4, 4))) {
+            WallDef def = {b2Vec2(v[0], v[1]), b2Vec2(v[2], v[3])};
+            if (def.size.x <= 0.0f || def.size.y <= 0.0f) {
+                std::fprintf(stderr, "%s:%d: '%s' needs positive half extents\n", path, lineNumber, word.c_str());
+                ok = false;
+            }
+            (word == "wall" ? level->walls : level->water).push_back(def);
+        } else if (word == "moving" && (ok = need(6, 8))) {
+            MovingWaterDef mw;
+            mw.basePosition.Set(v[0], v[1]);
+            mw.position = mw.basePosition;
+            mw.size.Set(v[2], v[3]);
+            mw.amplitude = v[4];
+            mw.speed = v[5];
+            mw.phase = v.size() > 6 ? v[6] : 0.0f;
+            mw.direction = v.size() > 7 && v[7] < 0.0f ? -1.0f : 1.0f;
+            level->movingWater.push_back(mw);
+        } else if (word == "rating" && (ok = need(1, 3))) {
+            level->rating.parSeconds = v[0];
+            level->rating.successRate = v.size() > 1 ? v[1] : 0.0f;
+            level->rating.medianSeconds = v.size() > 2 ? v[2] : 0.0f;
+        } else if (ok) {
+            std::fprintf(stderr, "%s:%d: unknown directive '%s'\n", path, lineNumber, word.c_str());
+            ok = false;
+        }
+    }
+    std::fclose(file);
+    return ok;
+}
+
+static bool checkLevel(const LevelConfig &level)
+{
+    bool inside = level.ballStartPos.x > 0.0f && level.ballStartPos.x < level.width && level.ballStartPos.y > 0.0f &&
+                  level.ballStartPos.y < level.height && level.holePos.x > 0.0f && level.holePos.x < level.width &&
+                  level.holePos.y > 0.0f && level.holePos.y < level.height;
+    if (level.width <= 0.0f || level.height <= 0.0f || level.holeRadius <= 0.0f || !inside) {
+        std::fprintf(stderr, "levelc: level %d needs a positive size and hole radius and a start and hole inside the world\n",
+                     level.id);
+        return false;
+    }
+    return true;
+}
+
+static void exportLevel(const LevelConfig &level)
+{
+    // %.9g round-trips every float exactly
+    std::printf("level %d\n", level.id);
+    std::printf("size %.9g %.9g\n", level.width, level.height);
+    std::printf("start %.9g %.9g\n", level.ballStartPos.x, level.ballStartPos.y);
+    std::printf("hole %.9g %.9g %.9g\n", level.holePos.x, level.holePos.y, level.holeRadius);
+    for (const WallDef &w : level.walls)
+        std::printf("wall %.9g %.9g %.9g %.9g\n", w.position.x, w.position.y, w.size.x, w.size.y);
+    for (const WallDef &w : level.water)
+        std::printf("water %.9g %.9g %.9g %.9g\n", w.position.x, w.position.y, w.size.x, w.size.y);
+    for (const MovingWaterDef &mw : level.movingWater)
+        std::printf("moving %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n", mw.basePosition.x, mw.basePosition.y, mw.size.x,
+                    mw.size.y, mw.amplitude, mw.speed, mw.phase, mw.direction);
+    if (level.rating.parSeconds > 0.0f)
+        std::printf("rating %.9g %.9g %.9g\n", level.rating.parSeconds, level.rating.successRate,
+                    level.rating.medianSeconds);
+    std::printf("\n");
+}
+
+static bool listPack(const char *path)
+{
+    LevelPack pack;
+    if (!pack.open(path))
+        return false;
+    std::printf("%s: %d levels\n", path, pack.count());
+    for (int i = 0; i < pack.count(); ++i) {
+        LevelView level;
+        pack.at(i, level);
+        std::printf("level %d: %.1f x %.1f m, %d walls, %d water, %d moving water", level.id, level.width,
+                    level.height, level.wallCount, level.waterCount, level.movingWaterCount);
+        if (level.rating.parSeconds > 0.0f)
+            std::printf(", par %.0f s (success %.0f%%, median %.1f s)", level.rating.parSeconds,
+                        100.0f * level.rating.successRate, level.rating.medianSeconds);
+        std::printf("\n");
+    }
+    return true;
+}
+
+static void usage()
+{
+    std::fprintf(stderr, "usage: levelc -o PACK SOURCE...\n"
+                         "       levelc --export-builtin\n"
+                         "       levelc --list PACK\n");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 2 && !std::strcmp(argv[1], "--export-builtin")) {
+        std::printf("# Built-in levels (LevelData.h) in levelc source form\n\n");
+        for (int id = 1; id <= LevelData::LEVEL_COUNT; ++id)
+            exportLevel(LevelData::getLevel(id));
+        return 0;
+    }
+    if (argc == 3 && !std::strcmp(argv[1], "--list"))
+        return listPack(argv[2]) ? 0 : 1;
+    if (argc < 4 || std::strcmp(argv[1], "-o")) {
+        usage();
+        return 2;
+    }
+
+    std::vector<LevelConfig> levels;
+    for (int i = 3; i < argc; ++i) {
+        if (!parseFile(argv[i], levels))
+            return 1;
+    }
+    for (const LevelConfig &level : levels) {
+        if (!checkLevel(level))
+            return 1;
+    }
+    if (!LevelPack::write(argv[2], levels))
+        return 1;
+    std::printf("levelc: %zu levels written to %s\n", levels.size(), argv[2]);
+    return 0;
+}
@@ -0,0 +1,14 @@
+# Level compiler: level source files -> binary level pack (see levelc.cpp).
+# Desktop build:  qmake levelc.pro && make
+
+TEMPLATE = app
+TARGET = levelc
+CONFIG += console
+CONFIG -= qt app_bundle
+INCLUDEPATH += ..
+include(../Box2D.pri)
+LIBS += -lm
+
+HEADERS += ../LevelData.h ../LevelPack.h
+
+SOURCES += levelc.cpp ../LevelData.cpp ../LevelPack.cpp